@@ -1,54 +1,267 @@
-#pragma once
-#include <iostream>
-
-/*******************************************************************************
-**  Binary Search Tree Abstract Data Type Definition (Duplicate keys allowed)
-*******************************************************************************/
-template <typename Key, typename Value>
-class BinarySearchTree {
-  public:
-    BinarySearchTree             () = default;
-    BinarySearchTree             ( const BinarySearchTree & original );     // performs a deep copy
-    BinarySearchTree & operator= (       BinarySearchTree   rhs      );     // performs a deep copy assignment  NOTE: INTENTIONALLY PASSED BY VALUE (delegates to copy constructor)
-   ~BinarySearchTree             ();                                        // performs a deep node destruction
-
-    // Queries
-    Value search     ( const Key & key )                       const;       // zyBook 6.4, 6.10:  Returns the value associated with the first node found matching given key. Throws invalid_argument if key not found
-    void insert      ( const Key & key, const Value & value );              // zyBook 6.5, 6.9, 6.10:  Inserts a new node populated with key and value in a proper location obeying the BST ordering property.
-    void remove      ( const Key & key );                                   // zyBook 6.6, 6.9, 6.10:  Removes the first-found matching node, restructuring the tree to preserve the BST ordering property.
-    void printInorder()                                        const;       // zyBook 6.7:  Prints the contents of the tree in ascending sorted order
-    int  getHeight   ()                                        const;       // zyBook 6.8:  Returns the height of the tree, or -1 if tree is empty
-
-    void clear();                                                           // Returns the tree to an empty state releasing all nodes
-
-
-  private:
-    struct Node;
-    Node * root_ = nullptr;
-
-    // Helper functions
-    void clear          ( Node * node );
-    void insertIterative( Node * node );                                    // zyBook Figure 6.9.1: BSTInsert algorithm for BSTs with nodes containing parent pointers.
-    void insertRecursive( Node * parent, Node * nodeToInsert );             // zyBook Figure 6.10.2: Recursive BST insertion and removal.
-    void remove         ( Node * node );                                    // zyBook Figure 6.9.3: BSTRemoveKey and BSTRemoveNode algorithms for BSTs with nodes containing parent pointers.  (Figure 6.10.2 identical but passes parent instead of using parent pointer in Node)
-    void printInorder   ( Node * node ) const;                              // zyBook Figure 6.7.1: BST inorder traversal algorithm.
-    int  getHeight      ( Node * node ) const;                              // zyBook Figure 6.8.3: BSTGetHeight algorithm.
-
-
-    Node * makeCopy( Node * node );                                         // Copy constructor helper function
-
-    Node * searchIterative(              const Key & key ) const;           // zyBook Figure 6.4.1: BST search algorithm.
-    Node * searchRecursive( Node * node, const Key & key ) const;           // zyBook Figure 6.10.1: BST recursive search algorithm.
-
-    bool replaceChild( Node * parent,                                       // zyBook Figure 6.9.2: BSTReplaceChild algorithm.
-                       Node * currentChild,
-                       Node * newChild );
-  };
-
-
-
-
-
-
-// Include template function definitions
-#include "BinarySearchTree.hxx"
+#pragma once
+#include <cstddef>    // size_t
+#include <iostream>
+#include <utility>    // pair
+#include <vector>
+
+#include "FrozenBinarySearchTree.hpp"
+#include "NodePool.hpp"
+#include "SnapshotIO.hpp"
+#include "TaskPool.hpp"
+
+/*******************************************************************************
+**  Balancing policies
+**    NONE       - plain BST, shape depends entirely on insertion order (zyBook chapter 6)
+**    AVL        - height balanced, subtree heights differ by at most 1.  Height < 1.44 log2(n+2)
+**    RED_BLACK  - color balanced, fewer rotations than AVL.  Height <= 2 log2(n+1)
+**    SPLAY      - self-adjusting, every search, insert, and remove rotates the node it reached to the root.  Frequently accessed keys
+**                 stay near the top, O(log n) amortized.  Lookups change the tree's shape (never its contents), so even const
+**                 lookups must not run concurrently
+*******************************************************************************/
+enum class BalancePolicy { NONE, AVL, RED_BLACK, SPLAY };
+
+
+
+
+/*******************************************************************************
+**  Node allocation policies
+**    HEAP  - each node is individually allocated with new and released with delete
+**    POOL  - nodes are carved from slabs owned by the tree, removed nodes are recycled, and clear() releases whole slabs at once
+*******************************************************************************/
+enum class AllocationPolicy { HEAP, POOL };
+
+
+
+
+/*******************************************************************************
+**  Binary Search Tree Abstract Data Type Definition (Duplicate keys allowed)
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance = BalancePolicy::NONE, AllocationPolicy Allocation = AllocationPolicy::HEAP>
+class BinarySearchTree {
+  public:
+    class Iterator;                                                         // A bidirectional inorder iterator
+    class ConstIterator;                                                    // The same, but the values are read-only.  Const trees hand out these
+
+    BinarySearchTree             () = default;
+    BinarySearchTree             ( const BinarySearchTree & original );     // performs a deep copy
+    BinarySearchTree             (       BinarySearchTree && original ) noexcept;   // takes over original's nodes, leaving original empty.  O(1)
+    template <typename InputIterator>
+    BinarySearchTree             ( InputIterator first,                     // Builds a balanced tree from a range of (key, value) pairs, see assign()
+                                   InputIterator last,
+                                   bool          isSorted = true );
+    BinarySearchTree & operator= (       BinarySearchTree   rhs      );     // performs a deep copy, or O(1) move, assignment  NOTE: INTENTIONALLY PASSED BY VALUE (delegates to copy or move constructor)
+   ~BinarySearchTree             ();                                        // performs a deep node destruction
+
+    // Queries
+    Value search     ( const Key & key )                       const;       // zyBook 6.4, 6.10:  Returns the value associated with the first node found matching given key. Throws invalid_argument if key not found
+    Value *       find( const Key & key );                                  // Returns the address of the value search() would return, or null if key not found.  Nothing is copied or thrown
+    const Value * find( const Key & key )                      const;
+    void insert      ( const Key & key, const Value & value );              // zyBook 6.5, 6.9, 6.10:  Inserts a new node populated with key and value in a proper location obeying the BST ordering property.
+    void insert      (       Key && key,       Value && value );            // Same, but moves key and value into the node
+    template <typename KeyArg, typename... ValueArgs>
+    Iterator emplace ( KeyArg && key, ValueArgs &&... valueArgs );          // Inserts a new node whose value is constructed in place from valueArgs.  Returns an Iterator to it
+    void remove      ( const Key & key );                                   // zyBook 6.6, 6.9, 6.10:  Removes the first-found matching node, restructuring the tree to preserve the BST ordering property.  Iterators to other entries remain valid
+    void printInorder()                                        const;       // zyBook 6.7:  Prints the contents of the tree in ascending sorted order
+    int  getHeight   ()                                        const;       // zyBook 6.8:  Returns the height of the tree, or -1 if tree is empty.  O(1)
+    std::size_t size ()                                        const;       // Returns the number of entries in the tree.  O(1)
+
+    // Order statistics, O(log n) using the subtree sizes kept in every node
+    std::size_t rank      ( const Key & key ) const;                        // Returns the number of keys less than key
+    Iterator      select    ( std::size_t k   );                            // Returns an Iterator to the k-th smallest key, counting from 0.  Throws range_error if k >= size()
+    ConstIterator select    ( std::size_t k   ) const;
+    Iterator      percentile( double fraction );                            // Returns an Iterator to the nearest-rank percentile, e.g. 0.5 for p50 and 0.99 for p99.  Throws range_error if the tree is empty or fraction isn't in [0, 1]
+    ConstIterator percentile( double fraction ) const;
+
+    FrozenBinarySearchTree<Key, Value> freeze() const;                      // Returns an immutable, pointer free copy of the tree optimized for search
+
+    // Iterators and range queries.  All keys in [a, b) are visited by iterating from lower_bound(a) to lower_bound(b) in O(log n + k)
+    Iterator      begin      ();                                            // Returns an Iterator to the smallest key, end() if the tree is empty
+    ConstIterator begin      ()                  const;
+    Iterator      end        ();                                            // Returns an Iterator beyond the largest key.  Do not dereference this Iterator
+    ConstIterator end        ()                  const;
+    Iterator      lower_bound( const Key & key );                           // Returns an Iterator to the first key not less than key (the first inserted of duplicates), or end()
+    ConstIterator lower_bound( const Key & key ) const;
+    Iterator      upper_bound( const Key & key );                           // Returns an Iterator to the first key greater than key, or end()
+    ConstIterator upper_bound( const Key & key ) const;
+    std::pair<Iterator,      Iterator>
+                  equal_range( const Key & key );                           // Returns the range of all entries matching key, { lower_bound(key), upper_bound(key) }
+    std::pair<ConstIterator, ConstIterator>
+                  equal_range( const Key & key ) const;
+
+    void clear();                                                           // Returns the tree to an empty state releasing all nodes
+
+    template <typename InputIterator>
+    void assign( InputIterator first,                                       // Replaces the contents with a perfectly balanced tree built in linear time from a range of (key, value) pairs
+                 InputIterator last,                                        // in ascending key order.  Set isSorted to false to have the range (stable) sorted first, O(n log n).
+                 bool          isSorted = true );                           // Duplicate keys keep their order in the range, the first is the one search() finds
+
+    // Splitting, joining, and set operations
+    BinarySearchTree split          ( const Key & key );                    // Removes every entry whose key is not less than key and returns them as a new tree.  O(log n), O(log^2 n) when red-black.  Pooled nodes moved out are reallocated, O(min(k, n-k))
+    void             join           ( BinarySearchTree && other );          // Moves all of other's entries into this tree, after any equal keys already here.  Throws invalid_argument if any of other's keys is less than a key in this tree.  O(log n)
+    BinarySearchTree setUnion       ( const BinarySearchTree & other ) const;   // Returns a new tree holding the entries of either tree.  A key found in both is kept as many times as the larger count, this tree's entries first.  O(n + m)
+    BinarySearchTree setIntersection( const BinarySearchTree & other ) const;   // Returns a new tree holding this tree's entries whose key is also in other, as many times as the smaller count.  O(n + m)
+    BinarySearchTree setDifference  ( const BinarySearchTree & other ) const;   // Returns a new tree holding this tree's entries whose key isn't matched in other, counting duplicates.  O(n + m)
+
+    // Binary snapshots.  Keys and values are encoded with SnapshotIO<Key> and SnapshotIO<Value>
+    void save( std::ostream & stream ) const;                               // Writes every entry to stream in ascending key order.  Open files in binary mode
+    void load( std::istream & stream );                                     // Replaces the contents with a snapshot written by save(), rebuilt balanced in linear time without comparing keys.
+                                                                            // Throws runtime_error if stream doesn't hold a complete snapshot, leaving the tree unchanged
+
+
+  private:
+    struct Node;
+    mutable Node * root_ = nullptr;                                         // mutable only so splaying lookups can restructure the tree
+    NodePool<Node> pool_;                                                   // Unused when Allocation == AllocationPolicy::HEAP
+
+    // Helper functions
+    template <typename... Args>
+    Node * newNode      ( Args &&... args );                                // Allocates and constructs a node according to the allocation policy
+    template <typename... Args>
+    static Node * allocateNode( NodePool<Node> & pool, Args &&... args );   // Same, but from the given pool when pool allocated
+    void   deleteNode   ( Node * node );                                    // Destroys and deallocates a node according to the allocation policy
+
+    void clear          ( Node * node );
+    void insertNode     ( Node * node );                                    // Links a new node into the tree and restores the balance property
+    void insertIterative( Node * node );                                    // zyBook Figure 6.9.1: BSTInsert algorithm for BSTs with nodes containing parent pointers.
+    void insertRecursive( Node * parent, Node * nodeToInsert );             // zyBook Figure 6.10.2: Recursive BST insertion and removal.
+    void remove         ( Node * node );                                    // Unlinks and then destroys node
+    void unlink         ( Node * node );                                    // zyBook Figure 6.9.3: BSTRemoveKey and BSTRemoveNode algorithms for BSTs with nodes containing parent pointers.  (Figure 6.10.2 identical but passes parent instead of using parent pointer in Node)
+    void printInorder   ( Node * node ) const;                              // zyBook Figure 6.7.1: BST inorder traversal algorithm.
+    int  getHeight      ( Node * node ) const;                              // zyBook Figure 6.8.3: BSTGetHeight algorithm.  (Recomputes from scratch, getHeight() uses the cached heights instead)
+
+
+    Node * makeCopy( Node * node, NodePool<Node> & pool );                  // Copy constructor helper function
+
+    // Copying and clearing large trees is spread across the shared TaskPool, one subtree of at most PARALLEL_GRAIN nodes per task
+    static constexpr std::size_t PARALLEL_GRAIN = 1 << 15;
+
+    static constexpr char SNAPSHOT_TAG[ 8 ] = { 'B', 'S', 'T', 'S', 'N', 'A', 'P', '1' };   // first bytes of every snapshot, the last is the format version
+
+    struct CopyTask { Node * original;  Node * parent;  Node ** link; };    // copy original's subtree, attach it under parent at link
+
+    Node *      makeParallelCopy( Node * originalRoot );
+    void        copyTop         ( Node * originalNode, Node * parent, Node ** link, std::vector<CopyTask> & tasks );   // copies the nodes above the tasks
+    void        clearParallel   ( Node * root );
+    static void partition       ( Node * node, std::vector<Node *> & top, std::vector<Node *> & subtrees );          // splits into large nodes near the root and the task sized subtrees below them
+
+    static BinarySearchTree copySorted( const std::vector<Node *> & nodes );   // set operation helper function:  copies the entries of nodes, already in ascending key order, into a new balanced tree
+    void   inorderNodes ( std::vector<Node *> & nodes ) const;              // Appends every node in inorder sequence
+
+    Node * join3        ( Node * left, Node * middle, Node * right );       // split() and join() helper function:  joins two detached subtrees and a middle node whose key lies between
+                                                                            // them into a balanced subtree, and returns its root.  O(height difference), O(height) when red-black
+    static int blackHeight( Node * node );                                  // Red-black:  the number of black nodes on every path from node down to a null child
+    static Node * relocate( Node * node, NodePool<Node> & from, NodePool<Node> & to );   // Moves the subtree's entries into nodes allocated from pool to, destroying the originals.  Returns the new subtree's root
+
+    void   linkBalanced ( const std::vector<Node *> & nodes );              // assign() and load() helper function:  replaces root_ with a balanced tree of the nodes, already in ascending key order
+    Node * buildBalanced( Node * const *      nodes,                        // assign() helper function:  links sorted nodes[first, last) into a balanced subtree under
+                          std::size_t         first,                        // parent.  runStarts[i] is the index of the first of nodes[i]'s duplicates (null if not
+                          std::size_t         last,                         // needed), and nodes at redDepth are colored red
+                          Node *              parent,
+                          const std::size_t * runStarts,
+                          int                 depth,
+                          int                 redDepth );
+
+    Node * searchIterative(              const Key & key ) const;           // zyBook Figure 6.4.1: BST search algorithm.
+    Node * searchRecursive( Node * node, const Key & key ) const;           // zyBook Figure 6.10.1: BST recursive search algorithm.
+
+    bool replaceChild( Node * parent,                                       // zyBook Figure 6.9.2: BSTReplaceChild algorithm.
+                       Node * currentChild,
+                       Node * newChild ) const;
+
+    static Node * minimum  ( Node * node );                                 // Leftmost node of the subtree rooted at node
+    static Node * successor( Node * node );                                 // Next node in inorder sequence (or null) found by following parent pointers
+    static Node * maximum    ( Node * node );                               // Rightmost node of the subtree rooted at node
+    static Node * predecessor( Node * node );                               // Previous node in inorder sequence (or null) found by following parent pointers
+
+    Node * firstMatch( Node * node ) const;                                 // Rotations may move equal keys left of the first-found match.  Returns the leftmost (first inserted) of them
+
+    // Balancing and augmentation helper functions (rebalancing is skipped when Balance == BalancePolicy::NONE)
+    // Rotations change the shape but never the contents, so they are const for the benefit of splay()
+    Node * rotateLeft           ( Node * node ) const;                      // zyBook AVLTreeRotateLeft / RBTreeRotateLeft algorithms. Returns the subtree's new root
+    Node * rotateRight          ( Node * node ) const;                      // zyBook AVLTreeRotateRight / RBTreeRotateRight algorithms. Returns the subtree's new root
+    void   splay                ( Node * node ) const;                      // Rotates node up to the root (does nothing if node is null)
+    void   rebalanceAfterInsert ( Node * node );                            // Restores the augmented attributes and balance property after node was inserted as a leaf
+    void   rebalanceAfterRemove ( Node * parent, Node * child, bool removedBlack );  // Restores the augmented attributes and balance property after a node under parent was spliced out and replaced by child
+
+    static int         height          ( Node * node );                     // cached height, -1 for an empty subtree
+    static std::size_t size            ( Node * node );                     // cached size, 0 for an empty subtree
+    static void        updateAttributes( Node * node );                     // zyBook AVLTreeUpdateHeight algorithm, extended to also update the size
+    Node *             rebalanceAVL    ( Node * node );                     // zyBook AVLTreeRebalance algorithm. Returns the subtree's new root
+    static bool        isRed           ( Node * node );                     // Red-black:  null children are black
+  };
+
+
+
+
+/*******************************************************************************
+**  Binary Search Tree bidirectional inorder iterator.  Steps follow parent pointers, so no stack is needed and a full traversal visits
+**  each edge twice, O(1) amortized per step.  The iterator, by definition, refers to a non-constant tree's values, but keys are
+**  read-only as changing them would break the BST ordering property.  A const tree hands out ConstIterators instead, which wrap an
+**  Iterator and give read-only access to the values as well.
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+class BinarySearchTree<Key, Value, Balance, Allocation>::Iterator
+{
+  friend class BinarySearchTree<Key, Value, Balance, Allocation>;
+
+  public:
+    Iterator() = default;
+
+    Iterator & operator++();                                                // advance to the next larger key (pre -increment)
+    Iterator   operator++( int );                                           // advance to the next larger key (post-increment)
+
+    Iterator & operator--();                                                // retreat to the next smaller key (pre -decrement).  Decrementing end() moves to the largest key
+    Iterator   operator--( int );                                           // retreat to the next smaller key (post-decrement)
+
+    const Key & key      () const;                                          // Key at the current position
+    Value &     value    () const;                                          // Value at the current position
+    Value &     operator*() const;                                          // Value at the current position
+    Value *     operator->() const;
+
+    bool operator==( const Iterator & rhs ) const;
+    bool operator!=( const Iterator & rhs ) const;
+
+  private:
+    Iterator( Node * node, const BinarySearchTree * tree );
+
+    Node *                   node_ = nullptr;                               // null at end()
+    const BinarySearchTree * tree_ = nullptr;                               // needed to step back from end()
+};
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+class BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator
+{
+  friend class BinarySearchTree<Key, Value, Balance, Allocation>;
+
+  public:
+    ConstIterator() = default;
+    ConstIterator( Iterator position );                                     // Implicit conversion, anything an Iterator refers to may be read
+
+    ConstIterator & operator++();                                           // advance to the next larger key (pre -increment)
+    ConstIterator   operator++( int );                                      // advance to the next larger key (post-increment)
+
+    ConstIterator & operator--();                                           // retreat to the next smaller key (pre -decrement).  Decrementing end() moves to the largest key
+    ConstIterator   operator--( int );                                      // retreat to the next smaller key (post-decrement)
+
+    const Key &   key      () const;                                        // Key at the current position
+    const Value & value    () const;                                        // Value at the current position
+    const Value & operator*() const;                                        // Value at the current position
+    const Value * operator->() const;
+
+    bool operator==( const ConstIterator & rhs ) const;
+    bool operator!=( const ConstIterator & rhs ) const;
+
+  private:
+    Iterator position_;
+};
+
+
+
+
+
+
+// Include template function definitions
+#include "BinarySearchTree.hxx"
@@ -1,451 +1,1985 @@
-#pragma once
-#include <iostream>
-#include <stdexcept>
-#include <algorithm>  // max(), swap()
-
-#include "BinarySearchTree.hpp"
-
-
-// This source file has both iterative and recursive implementations for some functions so the two can be studied and compared side
-// by side.  To select which version to use (compile and runtime), define either USING_ITERATIVE_FUNCTIONS or
-// USING_RECURSIVE_FUNCTIONS macro at compile time with the -DUSING_ITERATIVE_FUNCTIONS (or -DUSING_RECURSIVE_FUNCTIONS) compiler
-// switch, or by uncommenting out the line below to change the default from USING_RECURSIVE_FUNCTIONS to USING_ITERATIVE_FUNCTIONS
-
-//#define USING_ITERATIVE_FUNCTIONS
-#ifndef USING_ITERATIVE_FUNCTIONS
-  #define USING_RECURSIVE_FUNCTIONS
-#else
-  #undef USING_RECURSIVE_FUNCTIONS
-#endif
-
-
-
-
-
-/*******************************************************************************
-**  Binary Search Tree Node Definition
-*******************************************************************************/
-template<typename Key, typename Value>
-struct BinarySearchTree<Key, Value>::Node
-{
-  friend std::ostream & operator<<( std::ostream & stream, const Node & node )
-  {
-    stream << "Key: \"" << node.key_ << "\",  Value: \"" << node.value_ << "\"\n";
-    return stream;
-  }
-
-
-  // Constructors
-  Node( const Key & key = Key(), const Value & value = Value() );    // Also serves as the default constructor
-
-  // Public instance attributes
-  Key   key_;
-  Value value_;
-
-  // Private instance attributes
-  Node * left_   = nullptr;
-  Node * right_  = nullptr;
-  Node * parent_ = nullptr;
-};
-
-
-
-
-
-
-
-
-
-/*******************************************************************************
-**  BinarySearchTree<Key, Value>  Definitions
-*******************************************************************************/
-
-////////////////////////////////////////////////////////////////////////////////
-//   Constructors, destructor, assignments   
-////////////////////////////////////////////////////////////////////////////////
-template <typename Key, typename Value>
-BinarySearchTree<Key, Value>::BinarySearchTree( const BinarySearchTree & original )
-{ root_ = makeCopy( original.root_ ); }
-
-
-
-
-template <typename Key, typename Value>
-typename BinarySearchTree<Key, Value>::Node * BinarySearchTree<Key, Value>::makeCopy( Node * originalNode )
-{
-  if( originalNode == nullptr ) return nullptr;
-
-  auto node    = new Node( originalNode->key_, originalNode->value_ );
-  node->left_  = makeCopy( originalNode->left_ );
-  node->right_ = makeCopy( originalNode->right_ );
-
-  if( node->left_  != nullptr ) node->left_ ->parent_ = node;
-  if( node->right_ != nullptr ) node->right_->parent_ = node;
-
-  return node;
-}
-
-
-
-
-// Passing by value delegates copying the tree to the copy constructor, keeping the "copy" knowledge in one place.  The destructor
-// destroys the old tree when the rhs parameter goes out of scope. (Copy and swap idiom)
-template <typename Key, typename Value>
-BinarySearchTree<Key, Value> & BinarySearchTree<Key, Value>::operator=( BinarySearchTree rhs )
-{
-  auto temp = rhs.root_;
-  rhs.root_ = root_;
-  root_     = temp;
-
-  return *this;
-}
-
-
-
-
-template <typename Key, typename Value>
-BinarySearchTree<Key, Value>::~BinarySearchTree() 
-{ clear(); }
-
-
-
-
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::clear()
-{
-  clear( root_ );
-  root_ = nullptr;
-}
-
-
-
-
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::clear( Node * node )
-{
-  if( node == nullptr ) return;
-
-  clear( node->left_ );
-  clear( node->right_ );
-
-  delete node;
-}
-
-
-
-
-////////////////////////////////////////////////////////////////////////////////
-//  Search
-////////////////////////////////////////////////////////////////////////////////
-template <typename Key, typename Value>
-Value BinarySearchTree<Key, Value>::search( const Key  & key ) const
-{
-  #if defined(USING_ITERATIVE_FUNCTIONS)
-    auto node = searchIterative( key );                 // zyBook 6.4.1: BST search algorithm.
-  
-  #elif defined(USING_RECURSIVE_FUNCTIONS)
-    auto node = searchRecursive( root_, key );          // 6.10.1: BST recursive search algorithm.
-  
-  #endif
-
-  if( node == nullptr ) throw std::invalid_argument( "Key not found" );
-  return node->value_;
-}
-
-
-
-
-//  zyBook 6.4.1: BST search algorithm.
-template <typename Key, typename Value>
-typename BinarySearchTree<Key, Value>::Node * BinarySearchTree<Key, Value>::searchIterative( const Key & key ) const
-{
-  auto cur = root_;
-
-  while( cur != nullptr ) 
-  {
-    if     ( key == cur->key_ )  return cur;      // Found
-    else if( key  < cur->key_ )  cur = cur->left_;
-    else                         cur = cur->right_;
-  }
-
-  return nullptr; // Not found
-}
-
-
-
-
-//  zyBook 6.10.1: BST recursive search algorithm.
-template <typename Key, typename Value>
-typename BinarySearchTree<Key, Value>::Node * BinarySearchTree<Key, Value>::searchRecursive( Node * node, const Key & key ) const
-{
-  if( node != nullptr )
-  {
-    if     ( key == node->key_ )  return node;
-    else if( key  < node->key_ )  return searchRecursive( node->left_,  key );
-    else                          return searchRecursive( node->right_, key );
-  }
-
-  return nullptr;
-}
-
-
-
-
-////////////////////////////////////////////////////////////////////////////////
-//  Insert
-////////////////////////////////////////////////////////////////////////////////
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::insert( const Key & key, const Value & value ) 
-{
-  auto node = new Node( key, value );
-
-  #if defined(USING_ITERATIVE_FUNCTIONS)
-    insertIterative(        node );                          // Figure 6.9.1: BSTInsert algorithm for BSTs with nodes containing parent pointers.
-
-  #elif defined(USING_RECURSIVE_FUNCTIONS)
-    if( root_ == nullptr ) root_ = node;                     // Figure 6.10.2: Recursive BST insertion and removal.
-    else                   insertRecursive( root_, node );   // Figure 6.10.2: Recursive BST insertion and removal.
-
-  #endif
-}
-
-
-
-
-//  Figure 6.9.1: BSTInsert algorithm for BSTs with nodes containing parent pointers.
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::insertIterative( Node * node ) 
-{
-  node->left_  = nullptr;                                         // insert as a leaf (added to zyBook algorithm for completeness)
-  node->right_ = nullptr;
-
-  if( root_ == nullptr )                                          // Insert first node
-  {                                        
-    root_         = node;
-    node->parent_ = nullptr;
-
-    return;
-  }
-
-  auto cur = root_;
-  while( cur != nullptr )                                         // Search for insertion point, starting with the root
-  {
-    if( node->key_ < cur->key_ ) 
-    {
-      if( cur->left_ == nullptr )                                 // Found left insertion point
-      {
-        cur->left_    = node;
-        node->parent_ = cur;
-        cur           = nullptr;                                  // Stop searching
-      }
-      else  
-      {
-        cur = cur->left_;                                         // Continue searching left for insertion point
-      }
-    }
-
-    else   // node->key_ >= cur->key_   (This algorithm allows duplicate keys)
-    {
-      if( cur->right_ == nullptr )
-      {                                                           // Found right insertion point
-        cur->right_   = node;
-        node->parent_ = cur;
-        cur           = nullptr;                                  // Stop searching
-      }
-      else
-      {
-        cur = cur->right_;                                        // Continue searching right for insertion point
-      }
-    }
-  }
-}
-
-
-
-
-//  zyBook Figure 6.10.2: Recursive BST insertion and removal.  (Assumes parent and nodeToInsert are not null)
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::insertRecursive( Node * parent, Node * nodeToInsert )
-{
-  if( nodeToInsert->key_ < parent->key_ )
-  {
-    if( parent->left_ == nullptr )
-    {
-      parent->left_         = nodeToInsert;
-      nodeToInsert->parent_ = parent;                             // Not in zyBook algorithm, but needed when tree node contains parent pointer
-    }
-    else insertRecursive( parent->left_, nodeToInsert );
-  }
-  else
-  {
-    if( parent->right_ == nullptr )
-    {
-      parent->right_        = nodeToInsert;
-      nodeToInsert->parent_ = parent;                              // Not in zyBook algorithm, but needed when tree node contains parent pointer
-    }
-    else insertRecursive( parent->right_, nodeToInsert );
-  }
-}
-
-
-
-
-////////////////////////////////////////////////////////////////////////////////
-//  Remove
-////////////////////////////////////////////////////////////////////////////////
-//  zyBook Figure 6.9.3: BSTRemoveKey and BSTRemoveNode algorithms for BSTs with nodes containing parent pointers.
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::remove( const Key & key )
-{
-  #if defined(USING_ITERATIVE_FUNCTIONS)
-    auto node = searchIterative( key );
-
-  #elif defined(USING_RECURSIVE_FUNCTIONS)
-    auto node = searchRecursive( root_, key );
-
-  #endif
-
-  remove( node );
-}
-
-
-
-
-//  zyBook Figure 6.9.3: BSTRemoveKey and BSTRemoveNode algorithms for BSTs with nodes containing parent pointers.
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::remove( Node * node ) 
-{
-  if( node == nullptr ) return;
-
-  // Case 1: Internal node with 2 children
-  if ( node->left_ != nullptr  &&  node->right_ != nullptr)  
-  {
-    // Find successor (leftmost child of right subtree)
-    auto succNode = node->right_;
-    while( succNode->left_ != nullptr ) succNode = succNode->left_;
-
-    // Copy value/data from succNode to node
-    node->key_   = succNode->key_;
-    node->value_ = succNode->value_;
-
-    // Recursively remove succNode
-    remove( succNode );
-  }
-
-
-  else 
-  {
-    // Case 2: Root node (with 1 or 0 children)
-    if (node == root_) 
-    {
-      if( node->left_ != nullptr )  root_ = node->left_;
-      else                          root_ = node->right_;
-
-      // Make sure the new root, if non-null, has a null parent
-      if( root_ != nullptr ) root_->parent_ = nullptr;
-    }
-
-
-
-    // Case 3: Internal with left child only
-    else if( node->left_ != nullptr )   replaceChild( node->parent_, node, node->left_ );
-
-    // Case 4: Internal with right child only OR leaf
-    else                                replaceChild( node->parent_, node, node->right_ );
-
-    delete node;  // Not in zyBook algorithm, but needed to prevent memory leak
-  }
-}
-
-
-
-
-//  zyBook Figure 6.9.2: BSTReplaceChild algorithm.
-template <typename Key, typename Value>
-bool BinarySearchTree<Key, Value>::replaceChild( Node * parent,
-                                                 Node * currentChild,
-                                                 Node * newChild )
-{
-  if( parent->left_ != currentChild  &&  parent->right_ != currentChild )   return false;
-
-  if( parent->left_ == currentChild )  parent->left_  = newChild;
-  else                                 parent->right_ = newChild;
-
-  if( newChild != nullptr ) newChild->parent_ = parent;
-
-  return true;
-}
-
-
-
-
-////////////////////////////////////////////////////////////////////////////////
-//  Print
-////////////////////////////////////////////////////////////////////////////////
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::printInorder() const
-{
-  printInorder( root_ );
-}
-
-
-
-
-//  zyBook Figure 6.7.1: BST inorder traversal algorithm.
-template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::printInorder( Node * node ) const
-{
-  if( node == nullptr ) return;
-
-  printInorder( node->left_ );
-  std::cout << *node;
-  printInorder( node->right_ );
-}
-
-
-
-
-////////////////////////////////////////////////////////////////////////////////
-//  Height
-////////////////////////////////////////////////////////////////////////////////
-template <typename Key, typename Value>
-int BinarySearchTree<Key, Value>::getHeight() const
-{
-  return getHeight( root_ );
-}
-
-
-
-
-//  zyBook Figure 6.8.3: BSTGetHeight algorithm.
-template <typename Key, typename Value>
-int BinarySearchTree<Key, Value>::getHeight( Node * node ) const
-{
-  if( node == nullptr ) return -1;
-
-  auto leftHeight  = getHeight( node->left_  );
-  auto rightHeight = getHeight( node->right_ );
-
-  return 1 + std::max( leftHeight, rightHeight );
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-/*******************************************************************************
-**  BinarySearchTree<Key, Value>::Node  Definitions
-*******************************************************************************/
-template <typename Key, typename Value>
-BinarySearchTree<Key, Value>::Node::Node( const Key & key, const Value & value )
-  : key_( key ), value_( value )
-{}
+#pragma once
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>  // max(), min(), swap(), stable_sort(), equal(), set_union(), set_intersection(), set_difference()
+#include <cmath>      // ceil()
+#include <cstdint>    // uint64_t
+#include <iterator>   // iterator_traits, distance(), back_inserter()
+#include <limits>     // numeric_limits
+#include <new>        // placement new
+#include <type_traits>
+#include <utility>    // forward(), move(), as_const(), in_place, pair
+#include <vector>
+
+#include "BinarySearchTree.hpp"
+
+
+// This source file has both iterative and recursive implementations for some functions so the two can be studied and compared side
+// by side.  To select which version to use (compile and runtime), define either USING_ITERATIVE_FUNCTIONS or
+// USING_RECURSIVE_FUNCTIONS macro at compile time with the -DUSING_ITERATIVE_FUNCTIONS (or -DUSING_RECURSIVE_FUNCTIONS) compiler
+// switch, or by uncommenting out the line below to change the default from USING_RECURSIVE_FUNCTIONS to USING_ITERATIVE_FUNCTIONS
+
+//#define USING_ITERATIVE_FUNCTIONS
+#ifndef USING_ITERATIVE_FUNCTIONS
+  #define USING_RECURSIVE_FUNCTIONS
+#else
+  #undef USING_RECURSIVE_FUNCTIONS
+#endif
+
+
+
+
+
+/*******************************************************************************
+**  Binary Search Tree Node Definition
+*******************************************************************************/
+template<typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+struct BinarySearchTree<Key, Value, Balance, Allocation>::Node
+{
+  friend std::ostream & operator<<( std::ostream & stream, const Node & node )
+  {
+    stream << "Key: \"" << node.key_ << "\",  Value: \"" << node.value_ << "\"\n";
+    return stream;
+  }
+
+
+  // Constructors
+  Node( const Key & key = Key(), const Value & value = Value() );    // Also serves as the default constructor
+  template <typename KeyArg, typename... ValueArgs>
+  Node( std::in_place_t, KeyArg && key, ValueArgs &&... valueArgs ); // Constructs key_ from key and value_ from valueArgs in place
+
+  // Public instance attributes
+  Key   key_;
+  Value value_;
+
+  // Private instance attributes
+  Node * left_   = nullptr;
+  Node * right_  = nullptr;
+  Node * parent_ = nullptr;
+
+  // Balancing attribute (unused unless Balance == BalancePolicy::RED_BLACK)
+  bool   red_    = true;                                             // Red-black:  nodes are inserted red, the root is always black
+
+  // Augmented attributes describing the subtree rooted at this node, maintained by every structural change
+  int         height_ = 0;                                           // a leaf has height 0
+  std::size_t size_   = 1;                                           // number of nodes
+};
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  BinarySearchTree<Key, Value>  Definitions
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+//   Constructors, destructor, assignments   
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation>::BinarySearchTree( const BinarySearchTree & original )
+{
+  // Large trees are copied a subtree per task across all cores
+  if( size( original.root_ ) > 2 * PARALLEL_GRAIN )  root_ = makeParallelCopy( original.root_ );
+  else                                               root_ = makeCopy( original.root_, pool_ );
+}
+
+
+
+
+// The pools are swapped rather than moved so original is left with an empty one
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation>::BinarySearchTree( BinarySearchTree && original ) noexcept
+  : root_( original.root_ )
+{
+  original.root_ = nullptr;
+  pool_.swap( original.pool_ );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename InputIterator>
+BinarySearchTree<Key, Value, Balance, Allocation>::BinarySearchTree( InputIterator first, InputIterator last, bool isSorted )
+{ assign( first, last, isSorted ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::makeCopy( Node * originalNode, NodePool<Node> & pool )
+{
+  if( originalNode == nullptr ) return nullptr;
+
+  auto node     = allocateNode( pool, originalNode->key_, originalNode->value_ );
+  node->height_ = originalNode->height_;                              // an exact copy of the shape is already balanced
+  node->size_   = originalNode->size_;
+  node->red_    = originalNode->red_;
+
+  node->left_  = makeCopy( originalNode->left_,  pool );
+  node->right_ = makeCopy( originalNode->right_, pool );
+
+  if( node->left_  != nullptr ) node->left_ ->parent_ = node;
+  if( node->right_ != nullptr ) node->right_->parent_ = node;
+
+  return node;
+}
+
+
+
+
+//  The nodes near the root are copied serially, and each subtree hanging below them small enough to be a single task is copied in
+//  parallel.  Tasks never share a node, each links its copy into a distinct child pointer.  Pool allocated nodes are carved from a
+//  pool per task (pools aren't thread safe), and all of them are merged into this tree's pool afterwards.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::makeParallelCopy( Node * originalRoot )
+{
+  Node *                root = nullptr;
+  std::vector<CopyTask> tasks;
+  copyTop( originalRoot, nullptr, &root, tasks );
+
+  std::vector<NodePool<Node>> pools( Allocation == AllocationPolicy::POOL ? tasks.size() : 0 );
+
+  TaskPool::instance().parallelFor( tasks.size(), [&]( std::size_t i )
+  {
+    auto & task = tasks[ i ];
+    auto   copy = makeCopy( task.original, pools.empty() ? pool_ : pools[ i ] );   // pool_ is untouched for heap allocated nodes
+
+    copy->parent_ = task.parent;
+    *task.link    = copy;
+  } );
+
+  for( auto & pool : pools ) pool_.merge( pool );
+  return root;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::copyTop( Node * originalNode, Node * parent, Node ** link, std::vector<CopyTask> & tasks )
+{
+  if( originalNode == nullptr ) { *link = nullptr;  return; }
+
+  if( originalNode->size_ <= PARALLEL_GRAIN )                     // small enough, leave it for a task
+  {
+    tasks.push_back( { originalNode, parent, link } );
+    return;
+  }
+
+  auto node     = allocateNode( pool_, originalNode->key_, originalNode->value_ );
+  node->height_ = originalNode->height_;
+  node->size_   = originalNode->size_;
+  node->red_    = originalNode->red_;
+  node->parent_ = parent;
+  *link         = node;
+
+  copyTop( originalNode->left_,  node, &node->left_,  tasks );
+  copyTop( originalNode->right_, node, &node->right_, tasks );
+}
+
+
+
+
+// Passing by value delegates copying the tree to the copy constructor, keeping the "copy" knowledge in one place.  The destructor
+// destroys the old tree when the rhs parameter goes out of scope. (Copy and swap idiom)  Assigning from an rvalue move constructs rhs
+// instead, so move assignment costs no more than a few pointer swaps.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation> & BinarySearchTree<Key, Value, Balance, Allocation>::operator=( BinarySearchTree rhs )
+{
+  auto temp = rhs.root_;
+  rhs.root_ = root_;
+  root_     = temp;
+
+  pool_.swap( rhs.pool_ );                                        // the nodes and the slabs they live in go together
+
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation>::~BinarySearchTree() 
+{ clear(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::clear()
+{
+  // Pooled nodes with nothing to destroy don't need to be visited at all, the slabs are just handed back all at once
+  constexpr bool visitNodes = Allocation == AllocationPolicy::HEAP  ||  !std::is_trivially_destructible_v<Node>;
+
+  if constexpr( visitNodes )
+  {
+    if( size( root_ ) > 2 * PARALLEL_GRAIN )  clearParallel( root_ );
+    else                                      clear( root_ );
+  }
+
+  if constexpr( Allocation == AllocationPolicy::POOL ) pool_.release();
+
+  root_ = nullptr;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::clear( Node * node )
+{
+  if( node == nullptr ) return;
+
+  clear( node->left_ );
+  clear( node->right_ );
+
+  if constexpr( Allocation == AllocationPolicy::POOL ) node->~Node();    // storage goes back with the slabs
+  else                                                 delete node;
+}
+
+
+
+
+//  Each subtree below the large nodes near the root is released by its own task, then the large nodes themselves are released
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::clearParallel( Node * root )
+{
+  std::vector<Node *> top;
+  std::vector<Node *> subtrees;
+  partition( root, top, subtrees );
+
+  TaskPool::instance().parallelFor( subtrees.size(), [&]( std::size_t i ) { clear( subtrees[ i ] ); } );
+
+  for( auto node : top )
+  {
+    node->left_ = node->right_ = nullptr;                         // already released
+    clear( node );
+  }
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::partition( Node * node, std::vector<Node *> & top, std::vector<Node *> & subtrees )
+{
+  if( node == nullptr ) return;
+
+  if( node->size_ <= PARALLEL_GRAIN )
+  {
+    subtrees.push_back( node );
+    return;
+  }
+
+  top.push_back( node );
+  partition( node->left_,  top, subtrees );
+  partition( node->right_, top, subtrees );
+}
+
+
+
+
+//  Repeated insertion costs O(n log n) at best and O(n^2) on sorted input.  Linking already sorted nodes midpoint first costs O(n).
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename InputIterator>
+void BinarySearchTree<Key, Value, Balance, Allocation>::assign( InputIterator first, InputIterator last, bool isSorted )
+{
+  clear();
+
+  // Allocate all the nodes up front, from a single slab when the node count is known in advance
+  std::vector<Node *> nodes;
+  if constexpr( std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category> )
+  {
+    auto count = static_cast<std::size_t>( std::distance( first, last ) );
+    nodes.reserve( count );
+    if constexpr( Allocation == AllocationPolicy::POOL ) pool_.reserve( count );
+  }
+
+  try
+  {
+    for( ; first != last;  ++first )  nodes.push_back( newNode( first->first, first->second ) );
+  }
+  catch( ... )
+  {
+    for( auto node : nodes ) deleteNode( node );
+    throw;
+  }
+
+  // Sorting node pointers instead of the pairs themselves never moves a key or value.  Stable so duplicates keep their order.
+  if( !isSorted ) std::stable_sort( nodes.begin(), nodes.end(), []( const Node * lhs, const Node * rhs ) { return lhs->key_ < rhs->key_; } );
+
+  linkBalanced( nodes );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::linkBalanced( const std::vector<Node *> & nodes )
+{
+  // Without balancing, search() relies on the first of several duplicates being their common ancestor (as insertIterative leaves
+  // them), so subtree roots are moved back to the start of their run of duplicates.  Balanced trees find the first match regardless.
+  std::vector<std::size_t> runStarts;
+  if constexpr( Balance == BalancePolicy::NONE )
+  {
+    runStarts.resize( nodes.size() );
+    for( std::size_t i = 0;  i < nodes.size();  ++i )
+      runStarts[ i ] = ( i > 0  &&  !( nodes[ i - 1 ]->key_ < nodes[ i ]->key_ ) ) ? runStarts[ i - 1 ] : i;
+  }
+
+  // Midpoint splits leave every null child at one of two adjacent depths.  Unless the bottom level is full, coloring exactly the
+  // nodes on the bottom level red gives every path the same number of black nodes.
+  int redDepth = -1;                                              // -1: no red nodes at all
+  if( auto n = nodes.size();  ( n & ( n + 1 ) ) != 0 )            // n+1 not a power of 2, so the bottom level isn't full
+  {
+    redDepth = 0;
+    while( n >>= 1 ) ++redDepth;                                  // floor( log2(n) ), the depth of the bottom level
+  }
+
+  root_ = buildBalanced( nodes.data(), 0, nodes.size(), nullptr, runStarts.empty() ? nullptr : runStarts.data(), 0, redDepth );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::buildBalanced( Node * const *      nodes,
+                                                                                                                                     std::size_t         first,
+                                                                                                                                     std::size_t         last,
+                                                                                                                                     Node *              parent,
+                                                                                                                                     const std::size_t * runStarts,
+                                                                                                                                     int                 depth,
+                                                                                                                                     int                 redDepth )
+{
+  if( first == last ) return nullptr;
+
+  auto middle = first + ( last - first ) / 2;
+  if( runStarts != nullptr ) middle = std::max( first, runStarts[ middle ] );
+
+  auto node     = nodes[ middle ];
+  node->parent_ = parent;
+  node->left_   = buildBalanced( nodes, first,      middle, node, runStarts, depth + 1, redDepth );
+  node->right_  = buildBalanced( nodes, middle + 1, last,   node, runStarts, depth + 1, redDepth );
+  node->red_    = ( depth == redDepth );
+  updateAttributes( node );
+
+  return node;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename... Args>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::newNode( Args &&... args )
+{ return allocateNode( pool_, std::forward<Args>( args )... ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename... Args>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::allocateNode( NodePool<Node> & pool, Args &&... args )
+{
+  if constexpr( Allocation == AllocationPolicy::POOL )
+  {
+    auto storage = pool.allocate();
+    try
+    {
+      return new( storage ) Node( std::forward<Args>( args )... );
+    }
+    catch( ... )
+    {
+      pool.deallocate( storage );                                 // don't lose the slot if Key's or Value's copy throws
+      throw;
+    }
+  }
+  else return new Node( std::forward<Args>( args )... );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::deleteNode( Node * node )
+{
+  if constexpr( Allocation == AllocationPolicy::POOL )
+  {
+    node->~Node();
+    pool_.deallocate( node );                                     // recycled by the next newNode()
+  }
+  else delete node;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Search
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+Value BinarySearchTree<Key, Value, Balance, Allocation>::search( const Key  & key ) const
+{
+  auto value = find( key );
+
+  if( value == nullptr ) throw std::invalid_argument( "Key not found" );
+  return *value;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+Value * BinarySearchTree<Key, Value, Balance, Allocation>::find( const Key & key )
+{ return const_cast<Value *>( std::as_const( *this ).find( key ) ); }    // the tree is non-const, so its values are too
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Value * BinarySearchTree<Key, Value, Balance, Allocation>::find( const Key & key ) const
+{
+  if constexpr( Balance == BalancePolicy::SPLAY )
+  {
+    // Splay the match, or on a miss the last node visited, so repeated misses along the same deep path get cheaper too
+    Node * last = nullptr;
+    auto   node = root_;
+    while( node != nullptr  &&  !( key == node->key_ ) )
+    {
+      last = node;
+      node = key < node->key_ ? node->left_ : node->right_;
+    }
+
+    if( node == nullptr ) { splay( last );  return nullptr; }
+
+    node = firstMatch( node );
+    splay( node );
+    return &node->value_;
+  }
+
+  #if defined(USING_ITERATIVE_FUNCTIONS)
+    auto node = searchIterative( key );                 // zyBook 6.4.1: BST search algorithm.
+  
+  #elif defined(USING_RECURSIVE_FUNCTIONS)
+    auto node = searchRecursive( root_, key );          // 6.10.1: BST recursive search algorithm.
+  
+  #endif
+
+  if( node == nullptr ) return nullptr;
+  return &firstMatch( node )->value_;
+}
+
+
+
+
+//  zyBook 6.4.1: BST search algorithm.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::searchIterative( const Key & key ) const
+{
+  auto cur = root_;
+
+  while( cur != nullptr ) 
+  {
+    if     ( key == cur->key_ )  return cur;      // Found
+    else if( key  < cur->key_ )  cur = cur->left_;
+    else                         cur = cur->right_;
+  }
+
+  return nullptr; // Not found
+}
+
+
+
+
+//  zyBook 6.10.1: BST recursive search algorithm.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::searchRecursive( Node * node, const Key & key ) const
+{
+  if( node != nullptr )
+  {
+    if     ( key == node->key_ )  return node;
+    else if( key  < node->key_ )  return searchRecursive( node->left_,  key );
+    else                          return searchRecursive( node->right_, key );
+  }
+
+  return nullptr;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Insert
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::insert( const Key & key, const Value & value ) 
+{ insertNode( newNode( key, value ) ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::insert( Key && key, Value && value )
+{ insertNode( newNode( std::in_place, std::move( key ), std::move( value ) ) ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename KeyArg, typename... ValueArgs>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::emplace( KeyArg && key, ValueArgs &&... valueArgs )
+{
+  auto node = newNode( std::in_place, std::forward<KeyArg>( key ), std::forward<ValueArgs>( valueArgs )... );
+  insertNode( node );
+
+  return Iterator( node, this );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::insertNode( Node * node )
+{
+  #if defined(USING_ITERATIVE_FUNCTIONS)
+    insertIterative(        node );                          // Figure 6.9.1: BSTInsert algorithm for BSTs with nodes containing parent pointers.
+
+  #elif defined(USING_RECURSIVE_FUNCTIONS)
+    if( root_ == nullptr ) root_ = node;                     // Figure 6.10.2: Recursive BST insertion and removal.
+    else                   insertRecursive( root_, node );   // Figure 6.10.2: Recursive BST insertion and removal.
+
+  #endif
+
+  rebalanceAfterInsert( node );
+}
+
+
+
+
+//  Figure 6.9.1: BSTInsert algorithm for BSTs with nodes containing parent pointers.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::insertIterative( Node * node ) 
+{
+  node->left_  = nullptr;                                         // insert as a leaf (added to zyBook algorithm for completeness)
+  node->right_ = nullptr;
+
+  if( root_ == nullptr )                                          // Insert first node
+  {                                        
+    root_         = node;
+    node->parent_ = nullptr;
+
+    return;
+  }
+
+  auto cur = root_;
+  while( cur != nullptr )                                         // Search for insertion point, starting with the root
+  {
+    if( node->key_ < cur->key_ ) 
+    {
+      if( cur->left_ == nullptr )                                 // Found left insertion point
+      {
+        cur->left_    = node;
+        node->parent_ = cur;
+        cur           = nullptr;                                  // Stop searching
+      }
+      else  
+      {
+        cur = cur->left_;                                         // Continue searching left for insertion point
+      }
+    }
+
+    else   // node->key_ >= cur->key_   (This algorithm allows duplicate keys)
+    {
+      if( cur->right_ == nullptr )
+      {                                                           // Found right insertion point
+        cur->right_   = node;
+        node->parent_ = cur;
+        cur           = nullptr;                                  // Stop searching
+      }
+      else
+      {
+        cur = cur->right_;                                        // Continue searching right for insertion point
+      }
+    }
+  }
+}
+
+
+
+
+//  zyBook Figure 6.10.2: Recursive BST insertion and removal.  (Assumes parent and nodeToInsert are not null)
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::insertRecursive( Node * parent, Node * nodeToInsert )
+{
+  if( nodeToInsert->key_ < parent->key_ )
+  {
+    if( parent->left_ == nullptr )
+    {
+      parent->left_         = nodeToInsert;
+      nodeToInsert->parent_ = parent;                             // Not in zyBook algorithm, but needed when tree node contains parent pointer
+    }
+    else insertRecursive( parent->left_, nodeToInsert );
+  }
+  else
+  {
+    if( parent->right_ == nullptr )
+    {
+      parent->right_        = nodeToInsert;
+      nodeToInsert->parent_ = parent;                              // Not in zyBook algorithm, but needed when tree node contains parent pointer
+    }
+    else insertRecursive( parent->right_, nodeToInsert );
+  }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Remove
+////////////////////////////////////////////////////////////////////////////////
+//  zyBook Figure 6.9.3: BSTRemoveKey and BSTRemoveNode algorithms for BSTs with nodes containing parent pointers.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::remove( const Key & key )
+{
+  #if defined(USING_ITERATIVE_FUNCTIONS)
+    auto node = searchIterative( key );
+
+  #elif defined(USING_RECURSIVE_FUNCTIONS)
+    auto node = searchRecursive( root_, key );
+
+  #endif
+
+  remove( firstMatch( node ) );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::remove( Node * node ) 
+{
+  if( node == nullptr ) return;
+
+  unlink    ( node );
+  deleteNode( node );  // Not in zyBook algorithm, but needed to prevent memory leak
+}
+
+
+
+
+//  zyBook Figure 6.9.3: BSTRemoveKey and BSTRemoveNode algorithms for BSTs with nodes containing parent pointers.  The node is spliced
+//  out and the tree rebalanced, but the node itself is left for the caller to destroy or reuse.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::unlink( Node * node )
+{
+  // Case 1: Internal node with 2 children
+  if ( node->left_ != nullptr  &&  node->right_ != nullptr)  
+  {
+    // Find successor (leftmost child of right subtree)
+    auto succNode = node->right_;
+    while( succNode->left_ != nullptr ) succNode = succNode->left_;
+
+    // Rather than copying succNode's key and value into node (zyBook), succNode itself is moved into node's place.  Nothing is
+    // copied and every other node stays where it is, so iterators and pointers to the remaining entries stay valid.  As far as
+    // rebalancing is concerned it is still succNode's old position (it has no left child) that was spliced out.
+    auto child        = succNode->right_;
+    auto removedBlack = !succNode->red_;
+    auto parent       = succNode->parent_;
+
+    if( parent == node ) parent = succNode;                       // succNode keeps its right subtree
+    else
+    {
+      replaceChild( parent, succNode, child );                    // splice succNode out,
+      succNode->right_          = node->right_;                   // then adopt node's right subtree
+      succNode->right_->parent_ = succNode;
+    }
+
+    succNode->left_          = node->left_;
+    succNode->left_->parent_ = succNode;
+
+    if( node == root_ ) { root_ = succNode;  succNode->parent_ = nullptr; }
+    else                  replaceChild( node->parent_, node, succNode );
+
+    succNode->red_    = node->red_;                               // take over node's place in the balance too
+    succNode->height_ = node->height_;
+    succNode->size_   = node->size_;
+
+    rebalanceAfterRemove( parent, child, removedBlack );
+  }
+
+
+  else 
+  {
+    // Remember what the splice below changes so the tree can be rebalanced afterwards
+    auto parent       = node->parent_;
+    auto child        = node->left_ != nullptr ? node->left_ : node->right_;
+    auto removedBlack = !node->red_;
+
+    // Case 2: Root node (with 1 or 0 children)
+    if (node == root_) 
+    {
+      if( node->left_ != nullptr )  root_ = node->left_;
+      else                          root_ = node->right_;
+
+      // Make sure the new root, if non-null, has a null parent
+      if( root_ != nullptr ) root_->parent_ = nullptr;
+    }
+
+
+
+    // Case 3: Internal with left child only
+    else if( node->left_ != nullptr )   replaceChild( node->parent_, node, node->left_ );
+
+    // Case 4: Internal with right child only OR leaf
+    else                                replaceChild( node->parent_, node, node->right_ );
+
+    rebalanceAfterRemove( parent, child, removedBlack );
+  }
+}
+
+
+
+
+//  zyBook Figure 6.9.2: BSTReplaceChild algorithm.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool BinarySearchTree<Key, Value, Balance, Allocation>::replaceChild( Node * parent,
+                                                 Node * currentChild,
+                                                 Node * newChild ) const
+{
+  if( parent->left_ != currentChild  &&  parent->right_ != currentChild )   return false;
+
+  if( parent->left_ == currentChild )  parent->left_  = newChild;
+  else                                 parent->right_ = newChild;
+
+  if( newChild != nullptr ) newChild->parent_ = parent;
+
+  return true;
+}
+
+
+
+
+//  With duplicate keys, search stops at the first match found on the path from the root.  Without balancing that is also the first
+//  inserted because duplicates always descend right.  Rotations preserve the inorder sequence but may lift a later duplicate above
+//  earlier ones, so balanced trees continue into the left subtree looking for the leftmost (first inserted) match.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::firstMatch( Node * node ) const
+{
+  if constexpr( Balance == BalancePolicy::NONE ) return node;
+
+  else
+  {
+    if( node == nullptr ) return nullptr;
+
+    auto match = node;
+    auto cur   = node->left_;
+    while( cur != nullptr )                                       // every key in the left subtree is <= match's key
+    {
+      if( cur->key_ < match->key_ )  cur = cur->right_;
+      else                         { match = cur;  cur = cur->left_; }
+    }
+
+    return match;
+  }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Print
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::printInorder() const
+{
+  printInorder( root_ );
+}
+
+
+
+
+//  zyBook Figure 6.7.1: BST inorder traversal algorithm.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::printInorder( Node * node ) const
+{
+  if( node == nullptr ) return;
+
+  printInorder( node->left_ );
+  std::cout << *node;
+  printInorder( node->right_ );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Height
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+int BinarySearchTree<Key, Value, Balance, Allocation>::getHeight() const
+{
+  return height( root_ );                                         // maintained incrementally, no need to visit every node with getHeight( root_ )
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t BinarySearchTree<Key, Value, Balance, Allocation>::size() const
+{
+  return size( root_ );
+}
+
+
+
+
+//  zyBook Figure 6.8.3: BSTGetHeight algorithm.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+int BinarySearchTree<Key, Value, Balance, Allocation>::getHeight( Node * node ) const
+{
+  if( node == nullptr ) return -1;
+
+  auto leftHeight  = getHeight( node->left_  );
+  auto rightHeight = getHeight( node->right_ );
+
+  return 1 + std::max( leftHeight, rightHeight );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Iterators and range queries
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::begin() const
+{ return Iterator( minimum( root_ ), this ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::end() const
+{ return Iterator( nullptr, this ); }
+
+
+
+
+//  Like search, but remember the last node where the path turned left.  That is the smallest key not less than key seen so far.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::lower_bound( const Key & key ) const
+{
+  Node * bound = nullptr;
+
+  for( auto cur = root_;  cur != nullptr; )
+  {
+    if( cur->key_ < key )    cur = cur->right_;
+    else                   { bound = cur;  cur = cur->left_; }
+  }
+
+  return Iterator( bound, this );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::upper_bound( const Key & key ) const
+{
+  Node * bound = nullptr;
+
+  for( auto cur = root_;  cur != nullptr; )
+  {
+    if( key < cur->key_ )  { bound = cur;  cur = cur->left_; }
+    else                     cur = cur->right_;
+  }
+
+  return Iterator( bound, this );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::pair<typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator,
+          typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator> BinarySearchTree<Key, Value, Balance, Allocation>::equal_range( const Key & key ) const
+{ return { lower_bound( key ), upper_bound( key ) }; }
+
+
+
+
+//  A non-const tree's values may be changed, so its iterators are the const tree's with write access to the values
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::begin()
+{ return std::as_const( *this ).begin().position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::end()
+{ return std::as_const( *this ).end().position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::lower_bound( const Key & key )
+{ return std::as_const( *this ).lower_bound( key ).position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::upper_bound( const Key & key )
+{ return std::as_const( *this ).upper_bound( key ).position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::pair<typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator,
+          typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator> BinarySearchTree<Key, Value, Balance, Allocation>::equal_range( const Key & key )
+{ return { lower_bound( key ), upper_bound( key ) }; }
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Order statistics
+////////////////////////////////////////////////////////////////////////////////
+//  Like lower_bound, but every time the path turns right the node and its entire left subtree are smaller than key
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t BinarySearchTree<Key, Value, Balance, Allocation>::rank( const Key & key ) const
+{
+  std::size_t smaller = 0;
+
+  for( auto cur = root_;  cur != nullptr; )
+  {
+    if( cur->key_ < key )  { smaller += size( cur->left_ ) + 1;  cur = cur->right_; }
+    else                     cur = cur->left_;
+  }
+
+  return smaller;
+}
+
+
+
+
+//  The left subtree's size says whether the k-th smallest is to the left, right here, or to the right
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::select( std::size_t k ) const
+{
+  if( k >= size() ) throw std::range_error( "rank out of bounds" );
+
+  auto cur = root_;
+  while( true )
+  {
+    auto leftSize = size( cur->left_ );
+
+    if     ( k <  leftSize )   cur = cur->left_;
+    else if( k == leftSize )   return Iterator( cur, this );
+    else                     { k  -= leftSize + 1;  cur = cur->right_; }
+  }
+}
+
+
+
+
+//  Nearest-rank method:  the smallest key with at least fraction of all the keys at or below it
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::percentile( double fraction ) const
+{
+  if( !( fraction >= 0.0  &&  fraction <= 1.0 ) ) throw std::range_error( "percentile out of bounds" );
+
+  auto nearestRank = static_cast<std::size_t>( std::ceil( fraction * size() ) );   // 1 based
+  return select( nearestRank == 0 ? 0 : nearestRank - 1 );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::select( std::size_t k )
+{ return std::as_const( *this ).select( k ).position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::percentile( double fraction )
+{ return std::as_const( *this ).percentile( fraction ).position_; }
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Freeze
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+FrozenBinarySearchTree<Key, Value> BinarySearchTree<Key, Value, Balance, Allocation>::freeze() const
+{
+  std::vector<std::pair<Key, Value>> entries;
+
+  for( auto node = minimum( root_ );  node != nullptr;  node = successor( node ) )  entries.emplace_back( node->key_, node->value_ );
+
+  return FrozenBinarySearchTree<Key, Value>( std::move( entries ) );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Split, join, and set operations
+////////////////////////////////////////////////////////////////////////////////
+//  Walking down to where key belongs divides the path's nodes between the two sides.  Working back up, each node is joined with the
+//  subtree hanging off its far side and with the part of its side already built below it.  The joins' costs telescope to O(height).
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation> BinarySearchTree<Key, Value, Balance, Allocation>::split( const Key & key )
+{
+  std::vector<Node *> path;
+  for( auto node = root_;  node != nullptr;  node = node->key_ < key ? node->right_ : node->left_ )  path.push_back( node );
+
+  Node * left  = nullptr;
+  Node * right = nullptr;
+  for( auto i = path.size();  i-- > 0; )
+  {
+    auto node = path[ i ];
+    if( node->key_ < key )  left  = join3( node->left_, node, left          );
+    else                    right = join3( right,       node, node->right_ );
+  }
+
+  BinarySearchTree result;
+  root_        = left;
+  result.root_ = right;
+
+  // Pooled nodes must live in their own tree's pool, so the smaller side moves to a new pool
+  if constexpr( Allocation == AllocationPolicy::POOL )
+  {
+    if( size( right ) <= size( left ) )  result.root_ = relocate( right, pool_, result.pool_ );
+    else
+    {
+      root_ = relocate( left, pool_, result.pool_ );
+      pool_.swap( result.pool_ );
+    }
+  }
+
+  return result;
+}
+
+
+
+
+//  Balanced trees use other's smallest node to join the two trees in the middle.  Without balancing, other simply becomes the right
+//  subtree of this tree's largest node (the root, once splayed).
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::join( BinarySearchTree && other )
+{
+  if( this == &other ) throw std::invalid_argument( "A tree cannot be joined with itself" );
+
+  if( other.root_ == nullptr ) return;
+  if( root_       == nullptr ) { *this = std::move( other );  return; }
+
+  if( minimum( other.root_ )->key_ < maximum( root_ )->key_ ) throw std::invalid_argument( "Joined keys must not be less than the keys already in the tree" );
+
+  if constexpr( Allocation == AllocationPolicy::POOL ) pool_.merge( other.pool_ );
+
+  if constexpr( Balance == BalancePolicy::AVL  ||  Balance == BalancePolicy::RED_BLACK )
+  {
+    auto middle = minimum( other.root_ );
+    other.unlink( middle );
+    root_ = join3( root_, middle, other.root_ );
+  }
+  else
+  {
+    auto largest = maximum( root_ );
+    if constexpr( Balance == BalancePolicy::SPLAY ) splay( largest );
+
+    largest->right_       = other.root_;
+    other.root_->parent_  = largest;
+    for( auto node = largest;  node != nullptr;  node = node->parent_ )  updateAttributes( node );
+  }
+
+  other.root_ = nullptr;
+}
+
+
+
+
+//  AVL joins descend the taller tree's inner spine to a subtree about as tall as the shorter tree, red-black joins to a black node of
+//  the same black height.  The middle node takes that subtree's place with the shorter tree as its other child, and is then rebalanced
+//  exactly like a newly inserted node.  (Blelloch, Ferizovic, and Sun, "Just Join for Parallel Ordered Sets")
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::join3( Node * left, Node * middle, Node * right )
+{
+  if( left  != nullptr ) left ->parent_ = nullptr;
+  if( right != nullptr ) right->parent_ = nullptr;
+  middle->parent_ = nullptr;
+
+  Node * taller = nullptr;                                        // null if the two sides can simply become middle's children
+  Node * parent = nullptr;                                        // the node on taller's spine that middle goes under
+  Node * cur    = nullptr;                                        // the subtree middle replaces
+
+  if constexpr( Balance == BalancePolicy::AVL )
+  {
+    if     ( height( left  ) > height( right ) + 1 ) for( taller = cur = left;   height( cur ) > height( right ) + 1;  cur = cur->right_ )  parent = cur;
+    else if( height( right ) > height( left  ) + 1 ) for( taller = cur = right;  height( cur ) > height( left  ) + 1;  cur = cur->left_  )  parent = cur;
+  }
+
+  if constexpr( Balance == BalancePolicy::RED_BLACK )
+  {
+    if( isRed( left  ) ) left ->red_ = false;                     // a standalone subtree's root may always be black
+    if( isRed( right ) ) right->red_ = false;
+
+    auto leftBlackHeight  = blackHeight( left  );
+    auto rightBlackHeight = blackHeight( right );
+    auto curBlackHeight   = std::max( leftBlackHeight, rightBlackHeight );
+
+    if     ( leftBlackHeight  > rightBlackHeight ) taller = cur = left;
+    else if( rightBlackHeight > leftBlackHeight  ) taller = cur = right;
+
+    while( taller != nullptr  &&  ( isRed( cur )  ||  curBlackHeight != std::min( leftBlackHeight, rightBlackHeight ) ) )
+    {
+      if( !isRed( cur ) ) --curBlackHeight;
+      parent = cur;
+      cur    = taller == left ? cur->right_ : cur->left_;
+    }
+
+    middle->red_ = ( taller != nullptr );                         // red below a node, black as the new root
+  }
+
+  if( taller == nullptr )
+  {
+    middle->left_  = left;
+    middle->right_ = right;
+    if( left  != nullptr ) left ->parent_ = middle;
+    if( right != nullptr ) right->parent_ = middle;
+    updateAttributes( middle );
+
+    return middle;
+  }
+
+  if( taller == left ) { middle->left_ = cur;   middle->right_ = right;  parent->right_ = middle; }
+  else                 { middle->left_ = left;  middle->right_ = cur;    parent->left_  = middle; }
+
+  if( middle->left_  != nullptr ) middle->left_ ->parent_ = middle;
+  if( middle->right_ != nullptr ) middle->right_->parent_ = middle;
+  middle->parent_ = parent;
+  updateAttributes( middle );
+
+  root_ = taller;                                                 // rebalancing works on root_
+  rebalanceAfterInsert( middle );
+  return root_;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+int BinarySearchTree<Key, Value, Balance, Allocation>::blackHeight( Node * node )
+{
+  int count = 0;
+  for( ;  node != nullptr;  node = node->left_ )  if( !node->red_ ) ++count;
+  return count;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::relocate( Node * node, NodePool<Node> & from, NodePool<Node> & to )
+{
+  if( node == nullptr ) return nullptr;
+
+  auto copy     = allocateNode( to, std::in_place, std::move( node->key_ ), std::move( node->value_ ) );
+  copy->height_ = node->height_;
+  copy->size_   = node->size_;
+  copy->red_    = node->red_;
+
+  copy->left_  = relocate( node->left_,  from, to );
+  copy->right_ = relocate( node->right_, from, to );
+  if( copy->left_  != nullptr ) copy->left_ ->parent_ = copy;
+  if( copy->right_ != nullptr ) copy->right_->parent_ = copy;
+
+  node->~Node();
+  from.deallocate( node );
+
+  return copy;
+}
+
+
+
+
+//  Both trees are already sorted, so the standard library's merge based set algorithms visit each entry once.  Only node pointers are
+//  merged, and only the entries kept are copied.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation> BinarySearchTree<Key, Value, Balance, Allocation>::setUnion( const BinarySearchTree & other ) const
+{
+  std::vector<Node *> lhs, rhs, result;
+  inorderNodes( lhs );
+  other.inorderNodes( rhs );
+
+  std::set_union( lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter( result ), []( const Node * a, const Node * b ) { return a->key_ < b->key_; } );
+  return copySorted( result );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation> BinarySearchTree<Key, Value, Balance, Allocation>::setIntersection( const BinarySearchTree & other ) const
+{
+  std::vector<Node *> lhs, rhs, result;
+  inorderNodes( lhs );
+  other.inorderNodes( rhs );
+
+  std::set_intersection( lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter( result ), []( const Node * a, const Node * b ) { return a->key_ < b->key_; } );
+  return copySorted( result );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation> BinarySearchTree<Key, Value, Balance, Allocation>::setDifference( const BinarySearchTree & other ) const
+{
+  std::vector<Node *> lhs, rhs, result;
+  inorderNodes( lhs );
+  other.inorderNodes( rhs );
+
+  std::set_difference( lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter( result ), []( const Node * a, const Node * b ) { return a->key_ < b->key_; } );
+  return copySorted( result );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation> BinarySearchTree<Key, Value, Balance, Allocation>::copySorted( const std::vector<Node *> & nodes )
+{
+  BinarySearchTree    result;
+  std::vector<Node *> copies;
+  copies.reserve( nodes.size() );
+  if constexpr( Allocation == AllocationPolicy::POOL ) result.pool_.reserve( nodes.size() );
+
+  try
+  {
+    for( auto node : nodes )  copies.push_back( result.newNode( node->key_, node->value_ ) );
+  }
+  catch( ... )
+  {
+    for( auto copy : copies ) result.deleteNode( copy );
+    throw;
+  }
+
+  result.linkBalanced( copies );
+  return result;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::inorderNodes( std::vector<Node *> & nodes ) const
+{
+  nodes.reserve( nodes.size() + size( root_ ) );
+  for( auto node = minimum( root_ );  node != nullptr;  node = successor( node ) )  nodes.push_back( node );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Snapshots
+////////////////////////////////////////////////////////////////////////////////
+//  A snapshot is a tag, the entry count, then the entries in inorder sequence.  Only the entries are saved, not the shape, so a
+//  snapshot can be loaded into a tree of any balance or allocation policy.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::save( std::ostream & stream ) const
+{
+  stream.write( SNAPSHOT_TAG, sizeof( SNAPSHOT_TAG ) );
+  SnapshotIO<std::uint64_t>::write( stream, size( root_ ) );
+
+  for( auto node = minimum( root_ );  node != nullptr;  node = successor( node ) )
+  {
+    SnapshotIO<Key  >::write( stream, node->key_   );
+    SnapshotIO<Value>::write( stream, node->value_ );
+  }
+
+  if( !stream ) throw std::runtime_error( "Snapshot could not be written" );
+}
+
+
+
+
+//  Entries are read straight into new nodes, and since save() wrote them in order they are linked together exactly like assign()
+//  does.  Nothing is compared and nothing is rebalanced, so loading costs little more than the reading.  The nodes are built in a
+//  separate tree (and pool) that replaces this one only once the whole snapshot has been read.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::load( std::istream & stream )
+{
+  char tag[ sizeof( SNAPSHOT_TAG ) ] = {};
+  if( !stream.read( tag, sizeof( tag ) )  ||  !std::equal( tag, tag + sizeof( tag ), SNAPSHOT_TAG ) ) throw std::runtime_error( "Not a BinarySearchTree snapshot" );
+
+  std::uint64_t count = 0;
+  SnapshotIO<std::uint64_t>::read( stream, count );
+
+  // A corrupt count must fail with runtime_error, not a huge allocation.  Every entry takes at least two bytes, and when the stream
+  // can't say how much is left only a modest reservation is made up front
+  constexpr std::uint64_t UNCHECKED_RESERVATION = 1 << 16;
+
+  auto bytesLeft = snapshotBytesLeft( stream );
+  if( count > bytesLeft / 2 ) throw std::runtime_error( "Snapshot truncated or corrupt" );
+
+  auto reservation = static_cast<std::size_t>( bytesLeft == std::numeric_limits<std::uint64_t>::max() ? std::min( count, UNCHECKED_RESERVATION ) : count );
+
+  BinarySearchTree    loaded;
+  std::vector<Node *> nodes;
+  try
+  {
+    nodes.reserve( reservation );
+    if constexpr( Allocation == AllocationPolicy::POOL ) loaded.pool_.reserve( reservation );
+
+    for( std::uint64_t i = 0;  i < count;  ++i )
+    {
+      Key   key;
+      Value value;
+      SnapshotIO<Key  >::read( stream, key   );
+      SnapshotIO<Value>::read( stream, value );
+
+      nodes.push_back( loaded.newNode( std::in_place, std::move( key ), std::move( value ) ) );
+    }
+  }
+  catch( ... )
+  {
+    for( auto node : nodes ) loaded.deleteNode( node );           // the current contents are untouched
+    throw;
+  }
+
+  loaded.linkBalanced( nodes );
+  *this = std::move( loaded );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::minimum( Node * node )
+{
+  if( node == nullptr ) return nullptr;
+
+  while( node->left_ != nullptr ) node = node->left_;
+  return node;
+}
+
+
+
+
+//  The successor is the leftmost node of the right subtree if there is one, otherwise the first ancestor reached from its left side
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::successor( Node * node )
+{
+  if( node->right_ != nullptr ) return minimum( node->right_ );
+
+  while( node->parent_ != nullptr  &&  node == node->parent_->right_ ) node = node->parent_;
+  return node->parent_;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::maximum( Node * node )
+{
+  if( node == nullptr ) return nullptr;
+
+  while( node->right_ != nullptr ) node = node->right_;
+  return node;
+}
+
+
+
+
+//  Mirror image of successor:  the rightmost node of the left subtree, otherwise the first ancestor reached from its right side
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::predecessor( Node * node )
+{
+  if( node->left_ != nullptr ) return maximum( node->left_ );
+
+  while( node->parent_ != nullptr  &&  node == node->parent_->left_ ) node = node->parent_;
+  return node->parent_;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Balancing
+////////////////////////////////////////////////////////////////////////////////
+//  zyBook AVLTreeRotateLeft / RBTreeRotateLeft algorithms.  node's right child takes node's place and node becomes its left child.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::rotateLeft( Node * node ) const
+{
+  auto rightChild     = node->right_;
+  auto rightLeftChild = rightChild->left_;
+
+  if( node->parent_ != nullptr )  replaceChild( node->parent_, node, rightChild );
+  else                          { root_ = rightChild;  root_->parent_ = nullptr; }
+
+  rightChild->left_ = node;
+  node->parent_     = rightChild;
+
+  node->right_ = rightLeftChild;
+  if( rightLeftChild != nullptr ) rightLeftChild->parent_ = node;
+
+  updateAttributes( node );                                       // node is now below rightChild, so update it first
+  updateAttributes( rightChild );
+
+  return rightChild;
+}
+
+
+
+
+//  zyBook AVLTreeRotateRight / RBTreeRotateRight algorithms.  node's left child takes node's place and node becomes its right child.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::rotateRight( Node * node ) const
+{
+  auto leftChild      = node->left_;
+  auto leftRightChild = leftChild->right_;
+
+  if( node->parent_ != nullptr )  replaceChild( node->parent_, node, leftChild );
+  else                          { root_ = leftChild;  root_->parent_ = nullptr; }
+
+  leftChild->right_ = node;
+  node->parent_     = leftChild;
+
+  node->left_ = leftRightChild;
+  if( leftRightChild != nullptr ) leftRightChild->parent_ = node;
+
+  updateAttributes( node );                                       // node is now below leftChild, so update it first
+  updateAttributes( leftChild );
+
+  return leftChild;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::rebalanceAfterInsert( Node * node )
+{
+  if constexpr( Balance == BalancePolicy::AVL )
+  {
+    // zyBook AVLTreeInsert algorithm:  rebalance every ancestor of the new leaf on the way back up to the root
+    auto cur = node->parent_;
+    while( cur != nullptr ) cur = rebalanceAVL( cur )->parent_;
+  }
+
+  auto inserted = node;
+
+  if constexpr( Balance == BalancePolicy::RED_BLACK )
+  {
+    // zyBook RBTreeBalance algorithm:  a red node may not have a red parent
+    while( node != root_  &&  isRed( node->parent_ ) )
+    {
+      auto parent      = node->parent_;
+      auto grandparent = parent->parent_;                         // parent is red so it isn't the root and grandparent exists
+
+      if( parent == grandparent->left_ )
+      {
+        auto uncle = grandparent->right_;
+        if( isRed( uncle ) )                                      // push grandparent's blackness down a level and continue from there
+        {
+          parent->red_ = uncle->red_ = false;
+          grandparent->red_          = true;
+          node                       = grandparent;
+          continue;
+        }
+
+        if( node == parent->right_ )                              // inner grandchild, rotate into an outer grandchild
+        {
+          rotateLeft( parent );
+          node   = parent;
+          parent = node->parent_;
+        }
+
+        parent->red_      = false;
+        grandparent->red_ = true;
+        rotateRight( grandparent );
+      }
+
+      else // mirror image
+      {
+        auto uncle = grandparent->left_;
+        if( isRed( uncle ) )
+        {
+          parent->red_ = uncle->red_ = false;
+          grandparent->red_          = true;
+          node                       = grandparent;
+          continue;
+        }
+
+        if( node == parent->left_ )
+        {
+          rotateRight( parent );
+          node   = parent;
+          parent = node->parent_;
+        }
+
+        parent->red_      = false;
+        grandparent->red_ = true;
+        rotateLeft( grandparent );
+      }
+    }
+
+    root_->red_ = false;
+  }
+
+  if constexpr( Balance != BalancePolicy::AVL )
+  {
+    // Every ancestor of the new leaf gained a node and may have grown taller.  Rotations above may also have changed the height of
+    // the rotated subtree, but any rotated node not on the new leaf's path to the root has already been recomputed from its children.
+    for( auto cur = inserted;  cur != nullptr;  cur = cur->parent_ )  updateAttributes( cur );
+  }
+
+  if constexpr( Balance == BalancePolicy::SPLAY ) splay( inserted );
+}
+
+
+
+
+//  parent is the spliced out node's parent (null if it was the root), and child is the node that took its place (possibly null)
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::rebalanceAfterRemove( Node * parent, Node * child, bool removedBlack )
+{
+  if constexpr( Balance == BalancePolicy::AVL )
+  {
+    // zyBook AVLTreeRemoveNode algorithm:  rebalance every ancestor of the spliced out node on the way back up to the root
+    while( parent != nullptr ) parent = rebalanceAVL( parent )->parent_;
+  }
+
+  auto splicedParent = parent;
+
+  if constexpr( Balance == BalancePolicy::RED_BLACK )
+  {
+    // Removing a red node never changes a path's black count.  Removing a black node leaves every path through child one black
+    // short.  A red child simply turns black, otherwise the missing black is pushed up the tree or borrowed from child's sibling.
+    auto node = child;
+    while( removedBlack  &&  node != root_  &&  !isRed( node ) )
+    {
+      if( node == parent->left_ )
+      {
+        auto sibling = parent->right_;                            // never null, the sibling's side has at least one black node
+        if( isRed( sibling ) )                                    // make the sibling black
+        {
+          sibling->red_ = false;
+          parent->red_  = true;
+          rotateLeft( parent );
+          sibling = parent->right_;
+        }
+
+        if( !isRed( sibling->left_ )  &&  !isRed( sibling->right_ ) )  // both sides now short a black, move the problem up a level
+        {
+          sibling->red_ = true;
+          node          = parent;
+          parent        = node->parent_;
+        }
+        else                                                      // borrow a black from the sibling's red child
+        {
+          if( !isRed( sibling->right_ ) )
+          {
+            sibling->left_->red_ = false;
+            sibling->red_        = true;
+            rotateRight( sibling );
+            sibling = parent->right_;
+          }
+
+          sibling->red_         = parent->red_;
+          parent->red_          = false;
+          sibling->right_->red_ = false;
+          rotateLeft( parent );
+          node = root_;
+        }
+      }
+
+      else // mirror image
+      {
+        auto sibling = parent->left_;
+        if( isRed( sibling ) )
+        {
+          sibling->red_ = false;
+          parent->red_  = true;
+          rotateRight( parent );
+          sibling = parent->left_;
+        }
+
+        if( !isRed( sibling->left_ )  &&  !isRed( sibling->right_ ) )
+        {
+          sibling->red_ = true;
+          node          = parent;
+          parent        = node->parent_;
+        }
+        else
+        {
+          if( !isRed( sibling->left_ ) )
+          {
+            sibling->right_->red_ = false;
+            sibling->red_         = true;
+            rotateLeft( sibling );
+            sibling = parent->left_;
+          }
+
+          sibling->red_        = parent->red_;
+          parent->red_         = false;
+          sibling->left_->red_ = false;
+          rotateRight( parent );
+          node = root_;
+        }
+      }
+    }
+
+    if( node != nullptr ) node->red_ = false;
+  }
+
+  if constexpr( Balance != BalancePolicy::AVL )
+  {
+    // Every ancestor of the spliced out node lost a node and may have become shorter (see rebalanceAfterInsert)
+    for( auto cur = splicedParent;  cur != nullptr;  cur = cur->parent_ )  updateAttributes( cur );
+  }
+
+  if constexpr( Balance == BalancePolicy::SPLAY ) splay( splicedParent );
+}
+
+
+
+
+//  Sleator and Tarjan's bottom-up splay.  A node in line with its parent (zig-zig) rotates the grandparent first, which roughly halves
+//  the depth of every node on the access path.  That is what makes splaying O(log n) amortized rather than merely moving node up.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::splay( Node * node ) const
+{
+  auto rotateUp = [this]( Node * child )                          // rotates child above its parent
+  {
+    if( child == child->parent_->left_ ) rotateRight( child->parent_ );
+    else                                 rotateLeft ( child->parent_ );
+  };
+
+  while( node != nullptr  &&  node->parent_ != nullptr )
+  {
+    auto parent      = node->parent_;
+    auto grandparent = parent->parent_;
+
+    if     ( grandparent == nullptr )                                             rotateUp( node   );   // zig
+    else if( ( node == parent->left_ ) == ( parent == grandparent->left_ ) ) { rotateUp( parent );  rotateUp( node ); }   // zig-zig
+    else                                                                     { rotateUp( node   );  rotateUp( node ); }   // zig-zag
+  }
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+int BinarySearchTree<Key, Value, Balance, Allocation>::height( Node * node )
+{ return node == nullptr ? -1 : node->height_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t BinarySearchTree<Key, Value, Balance, Allocation>::size( Node * node )
+{ return node == nullptr ? 0 : node->size_; }
+
+
+
+
+//  zyBook AVLTreeUpdateHeight algorithm, extended to the subtree size.  Assumes node's children are up to date.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void BinarySearchTree<Key, Value, Balance, Allocation>::updateAttributes( Node * node )
+{
+  node->height_ = 1 + std::max( height( node->left_ ), height( node->right_ ) );
+  node->size_   = 1 +           size  ( node->left_ ) +  size  ( node->right_ );
+}
+
+
+
+
+//  zyBook AVLTreeRebalance algorithm.  Left-right and right-left imbalances take a double rotation.
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Node * BinarySearchTree<Key, Value, Balance, Allocation>::rebalanceAVL( Node * node )
+{
+  updateAttributes( node );
+
+  auto balance = height( node->left_ ) - height( node->right_ );
+  if( balance == -2 )                                             // right heavy
+  {
+    if( height( node->right_->left_ ) > height( node->right_->right_ ) )  rotateRight( node->right_ );
+    return rotateLeft( node );
+  }
+
+  if( balance == 2 )                                              // left heavy
+  {
+    if( height( node->left_->right_ ) > height( node->left_->left_ ) )  rotateLeft( node->left_ );
+    return rotateRight( node );
+  }
+
+  return node;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool BinarySearchTree<Key, Value, Balance, Allocation>::isRed( Node * node )
+{ return node != nullptr  &&  node->red_; }
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  BinarySearchTree<Key, Value, Balance, Allocation>::Node  Definitions
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation>::Node::Node( const Key & key, const Value & value )
+  : key_( key ), value_( value )
+{}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename KeyArg, typename... ValueArgs>
+BinarySearchTree<Key, Value, Balance, Allocation>::Node::Node( std::in_place_t, KeyArg && key, ValueArgs &&... valueArgs )
+  : key_( std::forward<KeyArg>( key ) ), value_( std::forward<ValueArgs>( valueArgs )... )
+{}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  BinarySearchTree<Key, Value>::Iterator  Definitions
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::Iterator( Node * node, const BinarySearchTree * tree )
+  : node_( node ), tree_( tree )
+{}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator & BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator++()      // pre-increment
+{
+  if( node_ == nullptr ) throw std::invalid_argument( "Attempt to increment past the end" );
+  node_ = successor( node_ );
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator++( int )   // post-increment
+{
+  Iterator temp( *this );
+  operator++();  // Delegate to pre-increment leveraging error checking
+  return temp;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator & BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator--()      // pre -decrement
+{
+  auto previous = node_ == nullptr ? maximum( tree_ == nullptr ? nullptr : tree_->root_ ) : predecessor( node_ );
+
+  if( previous == nullptr ) throw std::invalid_argument( "Attempt to decrement before the beginning" );
+  node_ = previous;
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::Iterator BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator--( int )   // post-decrement
+{
+  Iterator temp( *this );
+  operator--();  // Delegate to pre-decrement leveraging error checking
+  return temp;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Key & BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::key() const
+{
+  if( node_ == nullptr ) throw std::invalid_argument( "Attempt to dereference end()" );
+  return node_->key_;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+Value & BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::value() const
+{
+  if( node_ == nullptr ) throw std::invalid_argument( "Attempt to dereference end()" );
+  return node_->value_;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+Value & BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator*() const
+{ return value(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+Value * BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator->() const
+{ return &value(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator==( const Iterator & rhs ) const
+{ return node_ == rhs.node_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool BinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator!=( const Iterator & rhs ) const
+{ return !( *this == rhs ); }
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  BinarySearchTree<Key, Value>::ConstIterator  Definitions
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::ConstIterator( Iterator position )
+  : position_( position )
+{}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator & BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator++()      // pre-increment
+{
+  ++position_;
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator++( int )   // post-increment
+{
+  ConstIterator temp( *this );
+  ++position_;
+  return temp;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator & BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator--()      // pre -decrement
+{
+  --position_;
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator--( int )   // post-decrement
+{
+  ConstIterator temp( *this );
+  --position_;
+  return temp;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Key & BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::key() const
+{ return position_.key(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Value & BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::value() const
+{ return position_.value(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Value & BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator*() const
+{ return position_.value(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Value * BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator->() const
+{ return &position_.value(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator==( const ConstIterator & rhs ) const
+{ return position_ == rhs.position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool BinarySearchTree<Key, Value, Balance, Allocation>::ConstIterator::operator!=( const ConstIterator & rhs ) const
+{ return position_ != rhs.position_; }
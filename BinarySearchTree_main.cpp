@@ -1,7 +1,61 @@
+#include <algorithm>  // shuffle(), fill_n()
+#include <chrono>
+#include <cmath>      // log2(), pow()
+#include <cstdint>    // uint64_t
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>  // runtime_error
 #include <string>
+#include <utility>    // pair
+#include <vector>
 
 #include "BinarySearchTree.hpp"
+#include "MultiBinarySearchTree.hpp"
+
+
+
+
+// Times search( key ) for every key in lookups.  Returns the average nanoseconds per lookup
+template <typename Search>
+double timeSearches( const std::vector<unsigned> & lookups, Search search )
+{
+  unsigned long long checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for( auto key : lookups ) checksum += search( key );
+  auto stop  = std::chrono::steady_clock::now();
+
+  if( checksum == 0 ) std::cerr << "Lookups found nothing\n";          // also keeps the loop from being optimized away
+  return std::chrono::duration<double, std::nano>( stop - start ).count() / lookups.size();
+}
+
+
+
+// Loads keys in the given order, then times the lookups.  Returns the average nanoseconds per lookup
+template <typename Tree>
+double timeLookups( const std::vector<unsigned> & keys, const std::vector<unsigned> & lookups )
+{
+  Tree tree;
+  for( auto key : keys ) tree.insert( key, key );
+
+  return timeSearches( lookups, [&]( unsigned key ) { return *tree.find( key ); } );
+}
+
+
+
+// Times inserting keys in the given order, then the lookups.  Returns the milliseconds to build the tree and the average nanoseconds
+// per lookup
+template <typename Tree>
+std::pair<double, double> timeBuildAndLookups( const std::vector<unsigned> & keys, const std::vector<unsigned> & lookups )
+{
+  auto start = std::chrono::steady_clock::now();
+  Tree tree;
+  for( auto key : keys ) tree.insert( key, key );
+  auto built = std::chrono::steady_clock::now();
+
+  return { std::chrono::duration<double, std::milli>( built - start ).count(),
+           timeSearches( lookups, [&]( unsigned key ) { return *tree.find( key ); } ) };
+}
 
 
 
@@ -29,10 +83,222 @@ int main()
 
   studentGrades.printInorder();                                       // print the entire BST
 
+  for( auto student = studentGrades.lower_bound( "C" ), last = studentGrades.lower_bound( "K" );  student != last;  ++student )
+  {                                                                   // print only the names in [ "C", "K" )
+    std::cout << student.key() << ": " << *student << '\n';
+  }
+
+  auto frozenGrades = studentGrades.freeze();                         // read-only copy laid out for fast searching
+  if( frozenGrades.search( myKey ) != value ) std::cerr << "Frozen tree search does not match\n";
+
   if( gradeBook.getHeight() != 3 ) std::cerr << "Tree height does not match expected\n";
 
+  auto kevinsGrade = gradeBook.find( "Kevin" );                       // Ellen has two children, so her successor Kevin takes her place
+  auto kevin       = gradeBook.lower_bound( "Kevin" );
   gradeBook.remove( "Ellen" );
   if( gradeBook.getHeight() != 2 ) std::cerr << "Tree height does not match expected\n";
+  if( gradeBook.find( "Kevin" ) != kevinsGrade  ||  *kevinsGrade != 3.25  ||  &*kevin != kevinsGrade  ||  kevin.key() != "Kevin" )
+  {
+    std::cerr << "Removal moved another entry\n";                     // handles to other entries must survive a two child removal
+  }
+
+  if( studentGrades.find( "Nobody" ) != nullptr ) std::cerr << "Missing key found\n";   // misses return null rather than throw
+  if( auto grade = studentGrades.find( "Kevin" ) ) *grade += 0.25;                      // and hits give access without copying
+
+  BinarySearchTree<std::string, std::string> transcripts;
+  transcripts.emplace( "Chen", 3, 'A' );                              // value constructed in place as std::string( 3, 'A' )
+  transcripts.insert( std::string( "Kumar" ), std::string( "BBA" ) ); // key and value moved into the node
+
+  auto moved = std::move( transcripts );                              // takes over the nodes, nothing is copied
+  if( moved.search( "Chen" ) != "AAA"  ||  transcripts.size() != 0 ) std::cerr << "Moved tree does not match expected\n";
+
+
+  // Sorted keys turn an unbalanced BST into a linked list, but balanced trees stay logarithmic.  Insert a million ascending keys, then
+  // remove every other one, and verify the heights stay within the AVL and red-black bounds
+  constexpr unsigned N = 1'000'000;
+  BinarySearchTree<unsigned, unsigned, BalancePolicy::AVL>       avlTree;
+  BinarySearchTree<unsigned, unsigned, BalancePolicy::RED_BLACK> redBlackTree;
+
+  for( unsigned key = 0;  key < N;  ++key )
+  {
+    avlTree     .insert( key, key );
+    redBlackTree.insert( key, key );
+  }
+  if( avlTree     .getHeight() >= 1.44 * std::log2( N + 2 ) ) std::cerr << "AVL tree height exceeds balance bound\n";
+  if( redBlackTree.getHeight() >   2.0 * std::log2( N + 1 ) ) std::cerr << "Red-black tree height exceeds balance bound\n";
+
+  for( unsigned key = 0;  key < N;  key += 2 )
+  {
+    avlTree     .remove( key );
+    redBlackTree.remove( key );
+  }
+  if( avlTree     .getHeight() >= 1.44 * std::log2( N/2 + 2 ) ) std::cerr << "AVL tree height exceeds balance bound after removal\n";
+  if( redBlackTree.getHeight() >   2.0 * std::log2( N/2 + 1 ) ) std::cerr << "Red-black tree height exceeds balance bound after removal\n";
+  if( avlTree.search( N-1 ) != N-1  ||  redBlackTree.search( N-1 ) != N-1 ) std::cerr << "Balanced tree search failed\n";
+
+  if( avlTree.size() != N/2  ||  avlTree.rank( N/2 ) != N/4  ||  avlTree.select( 0 ).key() != 1 ) std::cerr << "Order statistics do not match expected\n";
+  std::cout << "p50 key: " << avlTree.percentile( 0.50 ).key() << ",  p99 key: " << avlTree.percentile( 0.99 ).key() << '\n';
+
+  // Shard a tree at a pivot key and merge the shards back, O(log n) each, then combine whole trees in linear time
+  auto upperShard = redBlackTree.split( N/2 );
+  if( redBlackTree.size() != N/4  ||  upperShard.size() != N/4  ||  upperShard.begin().key() != N/2 + 1 ) std::cerr << "Split shards do not match expected\n";
+
+  redBlackTree.join( std::move( upperShard ) );
+  if( redBlackTree.size() != N/2  ||  redBlackTree.getHeight() > 2.0 * std::log2( N/2 + 1 ) ) std::cerr << "Joined tree does not match expected\n";
+
+  auto lowerKeys = avlTree;
+  auto upperKeys = lowerKeys.split( N/2 );
+  if( lowerKeys.setUnion( upperKeys ).size() != N/2  ||  lowerKeys.setIntersection( upperKeys ).size() != 0  ||  avlTree.setDifference( lowerKeys ).size() != N/4 )
+  {
+    std::cerr << "Set operations do not match expected\n";
+  }
+
+
+  // Heavily duplicated keys:  a million records under only a thousand keys.  One node per record makes the height track the record
+  // count, one node per key with a bucket of values makes it track the number of distinct keys
+  constexpr unsigned DistinctKeys = 1'000;
+  BinarySearchTree     <unsigned, unsigned, BalancePolicy::AVL> recordPerNode;
+  MultiBinarySearchTree<unsigned, unsigned, BalancePolicy::AVL> bucketPerKey;
+  for( unsigned record = 0;  record < N;  ++record )
+  {
+    recordPerNode.insert( record % DistinctKeys, record );
+    bucketPerKey .insert( record % DistinctKeys, record );
+  }
+  std::cout << "Duplicate keys:  node per record height " << recordPerNode.getHeight() << ",  node per key height " << bucketPerKey.getHeight() << '\n';
+
+  if( bucketPerKey.size() != N  ||  bucketPerKey.distinctKeys() != DistinctKeys  ||  bucketPerKey.count( 7 ) != N / DistinctKeys ) std::cerr << "Multimap sizes do not match expected\n";
+  if( bucketPerKey.search( 7 ) != recordPerNode.search( 7 )  ||  bucketPerKey.values( 7 )[ 1 ] != 7 + DistinctKeys )                 std::cerr << "Multimap values do not match expected\n";
+
+  bucketPerKey.remove( 7 );                                           // first inserted value only
+  if( !bucketPerKey.remove( 7, 7 + 5 * DistinctKeys )  ||  bucketPerKey.remove( 7, 7 ) ) std::cerr << "Multimap value removal does not match expected\n";
+  if( bucketPerKey.search( 7 ) != 7 + DistinctKeys  ||  bucketPerKey.count( 7 ) != N / DistinctKeys - 2 )                          std::cerr << "Multimap value removal does not match expected\n";
+  if( bucketPerKey.removeAll( 7 ) != N / DistinctKeys - 2  ||  bucketPerKey.count( 7 ) != 0  ||  bucketPerKey.distinctKeys() != DistinctKeys - 1 ) std::cerr << "Multimap key removal does not match expected\n";
+
+  MultiBinarySearchTree<std::string, double> gradeHistory;
+  gradeHistory.insert( "Kumar", 3.05 );
+  gradeHistory.insert( "Chen",  2.5  );
+  gradeHistory.insert( "Kumar", 3.6  );
+  gradeHistory.printInorder();
+
+
+  // Loading already sorted records all at once builds a perfectly balanced tree in linear time, even without a balancing policy
+  std::vector<std::pair<unsigned, unsigned>> sortedRecords;
+  for( unsigned key = 0;  key < N;  ++key ) sortedRecords.emplace_back( key, key );
+
+  BinarySearchTree<unsigned, unsigned> bulkLoaded( sortedRecords.begin(), sortedRecords.end() );
+  if( bulkLoaded.getHeight() != static_cast<int>( std::log2( N ) ) ) std::cerr << "Bulk loaded tree is not perfectly balanced\n";
+
+
+  // A snapshot restores a tree at roughly the cost of reading it back, rather than inserting every entry again
+  std::stringstream snapshot( std::ios::in | std::ios::out | std::ios::binary );
+  avlTree.save( snapshot );
+
+  auto loadStart = std::chrono::steady_clock::now();
+  BinarySearchTree<unsigned, unsigned, BalancePolicy::AVL> restored;
+  restored.load( snapshot );
+  std::cout << "Snapshot of " << restored.size() << " entries loaded in "
+            << std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - loadStart ).count() << " ms\n";
+  if( restored.size() != avlTree.size()  ||  restored.search( N-1 ) != N-1  ||  restored.rank( N/2 ) != N/4 ) std::cerr << "Restored tree does not match saved tree\n";
+
+  // A corrupt entry count fails with runtime_error instead of trying to allocate that many nodes.  An empty tree's snapshot is just
+  // the tag and the count, which gives the count's offset
+  std::stringstream emptySnapshot;
+  BinarySearchTree<unsigned, unsigned>().save( emptySnapshot );
+
+  auto corrupt = snapshot.str();
+  std::fill_n( corrupt.begin() + ( emptySnapshot.str().size() - sizeof( std::uint64_t ) ), sizeof( std::uint64_t ), '\xFF' );
+  try
+  {
+    std::istringstream corruptSnapshot( corrupt );
+    restored.load( corruptSnapshot );
+    std::cerr << "Corrupt snapshot was loaded\n";
+  }
+  catch( const std::runtime_error & )
+  {
+    if( restored.size() != avlTree.size() ) std::cerr << "Failed load changed the tree\n";
+  }
+
+
+  // Copying and clearing a large tree is spread across cores, one subtree per task
+  auto & taskPool = TaskPool::instance();
+  auto   cores    = taskPool.concurrency();
+  for( std::size_t threads = 1;  threads <= cores;  threads *= 2 )
+  {
+    taskPool.setConcurrency( threads );
+
+    auto start = std::chrono::steady_clock::now();
+    BinarySearchTree<unsigned, unsigned> copy( bulkLoaded );
+    auto copied = std::chrono::steady_clock::now();
+    copy.clear();
+    auto cleared = std::chrono::steady_clock::now();
+
+    std::cout << threads << " thread(s):  copy " << std::chrono::duration<double, std::milli>( copied  - start  ).count() << " ms,  "
+                                     << "clear " << std::chrono::duration<double, std::milli>( cleared - copied ).count() << " ms\n";
+  }
+  taskPool.setConcurrency( cores );
+
+  BinarySearchTree<unsigned, unsigned> copy( bulkLoaded );
+  if( copy.size() != N  ||  copy.getHeight() != bulkLoaded.getHeight()  ||  copy.search( N/3 ) != N/3 ) std::cerr << "Parallel copy does not match original\n";
+
+
+  // Skewed (Zipfian) lookups, where a few keys get most of the traffic.  A splay tree keeps the popular keys near the root, so lookups
+  // visit far fewer nodes, but every lookup also pays for the rotations that move the key found to the root
+  constexpr unsigned Keys = 100'000, Lookups = 2'000'000;
+  std::mt19937 random( 131 );
+
+  std::vector<unsigned> keys( Keys );
+  for( unsigned key = 0;  key < Keys;  ++key ) keys[ key ] = key;
+  std::shuffle( keys.begin(), keys.end(), random );                  // random insertion order
+
+  auto byPopularity = keys;                                          // and the popular keys scattered independently of it
+  std::shuffle( byPopularity.begin(), byPopularity.end(), random );
+
+  std::vector<double> weights( Keys );                                // the key of rank r is looked up in proportion to 1/r^1.3, about 95% of
+  for( unsigned rank = 0;  rank < Keys;  ++rank ) weights[ rank ] = 1.0 / std::pow( rank + 1.0, 1.3 );   // the lookups hit 5% of the keys
+  std::discrete_distribution<unsigned> zipf( weights.begin(), weights.end() );
+
+  std::vector<unsigned> lookups( Lookups );
+  for( auto & key : lookups ) key = byPopularity[ zipf( random ) ];
+
+  std::cout << "Zipfian lookups (ns each):  "
+            << "none "      << timeLookups<BinarySearchTree<unsigned, unsigned, BalancePolicy::NONE     >>( keys, lookups ) << ",  "
+            << "AVL "       << timeLookups<BinarySearchTree<unsigned, unsigned, BalancePolicy::AVL      >>( keys, lookups ) << ",  "
+            << "red-black " << timeLookups<BinarySearchTree<unsigned, unsigned, BalancePolicy::RED_BLACK>>( keys, lookups ) << ",  "
+            << "splay "     << timeLookups<BinarySearchTree<unsigned, unsigned, BalancePolicy::SPLAY    >>( keys, lookups ) << '\n';
+
+
+  // Uniform lookups in a tree too large for the caches.  The pointer tree's search follows a child pointer to a node somewhere else in
+  // memory at every level, while the frozen copy's keys sit in one array in breadth first order, so the next few levels are prefetched
+  constexpr unsigned LargeKeys = 1'000'000;
+  std::vector<unsigned> largeKeys( LargeKeys );
+  for( unsigned key = 0;  key < LargeKeys;  ++key ) largeKeys[ key ] = key;
+  std::shuffle( largeKeys.begin(), largeKeys.end(), random );
+
+  std::uniform_int_distribution<unsigned> anyKey( 0, LargeKeys - 1 );
+  std::vector<unsigned> uniformLookups( Lookups );
+  for( auto & key : uniformLookups ) key = anyKey( random );
+
+  BinarySearchTree<unsigned, unsigned> largeTree;
+  for( auto key : largeKeys ) largeTree.insert( key, key );
+  auto frozenLargeTree = largeTree.freeze();
+
+  #if defined(USING_ITERATIVE_FUNCTIONS)
+    const char * pointerSearch = "searchIterative";
+  #else
+    const char * pointerSearch = "searchRecursive";
+  #endif
+  std::cout << "Uniform lookups in " << LargeKeys << " keys (ns each):  "
+            << pointerSearch << ' ' << timeSearches( uniformLookups, [&]( unsigned key ) { return largeTree      .search( key ); } ) << ",  "
+            << "frozen "            << timeSearches( uniformLookups, [&]( unsigned key ) { return frozenLargeTree.search( key ); } ) << '\n';
+  if( frozenLargeTree.size() != LargeKeys  ||  frozenLargeTree.search( LargeKeys / 3 ) != largeTree.search( LargeKeys / 3 ) ) std::cerr << "Frozen tree search does not match\n";
+
+
+  // The same tree with its nodes carved from slabs rather than allocated one by one.  Building makes a heap request per slab instead
+  // of per node, and nodes allocated one after another sit next to each other in memory
+  auto heap = timeBuildAndLookups<BinarySearchTree<unsigned, unsigned, BalancePolicy::NONE, AllocationPolicy::HEAP>>( largeKeys, uniformLookups );
+  auto pool = timeBuildAndLookups<BinarySearchTree<unsigned, unsigned, BalancePolicy::NONE, AllocationPolicy::POOL>>( largeKeys, uniformLookups );
+  std::cout << "Build " << LargeKeys << " keys (ms):  heap " << heap.first  << ",  pool " << pool.first  << '\n'
+            << "Uniform lookups (ns each):  heap "            << heap.second << ",  pool " << pool.second << '\n';
 }
 
 
@@ -40,3 +306,12 @@ int main()
 // Explicit instantiation - a technique to ensure all functions of the template are created and semantically checked.  By default,
 // only functions called get instantiated so you won't know it has compile errors until you actually call it.
 template class BinarySearchTree<unsigned, float>;
+template class BinarySearchTree<unsigned, float, BalancePolicy::AVL>;
+template class BinarySearchTree<unsigned, float, BalancePolicy::RED_BLACK>;
+template class BinarySearchTree<unsigned, float, BalancePolicy::SPLAY>;
+template class BinarySearchTree<unsigned, float, BalancePolicy::NONE,      AllocationPolicy::POOL>;
+template class BinarySearchTree<std::string, std::string, BalancePolicy::AVL, AllocationPolicy::POOL>;
+template class FrozenBinarySearchTree<unsigned, float>;
+template class MultiBinarySearchTree<unsigned, float>;
+template class MultiBinarySearchTree<std::string, std::string, BalancePolicy::SPLAY, AllocationPolicy::POOL>;
+template class ValueBucket<std::string, 1>;
@@ -0,0 +1,383 @@
+#pragma once
+#include <atomic>
+#include <cstddef>    // size_t
+#include <mutex>
+#include <stdexcept>  // invalid_argument
+#include <thread>     // yield()
+#include <vector>
+
+/*******************************************************************************
+**  Concurrent Binary Search Tree (Duplicate keys allowed)
+**
+**  Any number of threads may search() while other threads insert() and remove().  Writers serialize on a mutex, but readers never
+**  take a lock:
+**
+**    1) Optimistic, version validated reads.  A writer that moves a node to a different place in the tree (the two child removal)
+**       makes the version odd while doing so and even again when done.  A reader remembers the version before descending and
+**       retries if it changed, because it may have been looking in the wrong place.  Adding a leaf or splicing out a node with at
+**       most one child never moves a surviving node, so those writes don't disturb readers at all.
+**
+**    2) Epoch based reclamation.  A node a reader may be standing on can't be deleted the moment it's unlinked.  Readers announce
+**       themselves in the current epoch (one of two), removed nodes are retired rather than deleted, and every so often the writer
+**       advances the epoch and waits for the readers of the previous one to leave.  Nothing retired before that can still be
+**       reachable by any reader, so it's deleted.
+**
+**  Keys and values never change once inserted, so readers can copy them without synchronization.  The tree is unbalanced, its shape
+**  is the same as BinarySearchTree<Key, Value> given the same sequence of inserts and removes.
+*******************************************************************************/
+template <typename Key, typename Value>
+class ConcurrentBinarySearchTree {
+  public:
+    ConcurrentBinarySearchTree             () = default;
+    ConcurrentBinarySearchTree             ( const ConcurrentBinarySearchTree & ) = delete;     // readers may be holding on to nodes
+    ConcurrentBinarySearchTree & operator= ( const ConcurrentBinarySearchTree & ) = delete;
+   ~ConcurrentBinarySearchTree             ();                              // No other thread may be using the tree
+
+    // Queries (lock free, may be called concurrently with each other and with the mutators)
+    Value       search( const Key & key ) const;                            // Returns the value associated with the first node found matching given key. Throws invalid_argument if key not found
+    bool        search( const Key & key, Value & value ) const;             // Copies the value associated with the first node found matching key into value.  Returns false if key not found
+    std::size_t size  ()                  const;                            // Returns the number of entries in the tree
+
+    // Mutators (serialized with each other)
+    void insert( const Key & key, const Value & value );                    // Inserts a new node populated with key and value in a proper location obeying the BST ordering property.
+    void remove( const Key & key );                                         // Removes the first-found matching node, restructuring the tree to preserve the BST ordering property.
+
+
+  private:
+    struct Node;
+    class  ReadGuard;
+
+    static constexpr std::size_t READER_SLOTS  = 64;                        // threads share slots round robin beyond this, costing only contention
+    static constexpr std::size_t RECLAIM_BATCH = 256;                       // retired nodes held before waiting out the readers
+
+    struct alignas( 64 ) ReaderSlot                                         // one cache line each, so readers in different slots don't contend
+    {
+      std::atomic<std::size_t> active_[ 2 ] = { {0}, {0} };                 // readers in this slot currently inside an even / odd epoch
+    };
+
+    std::atomic<Node *>        root_    { nullptr };
+    std::atomic<std::size_t>   size_    { 0 };
+    std::atomic<std::size_t>   version_ { 0 };                              // odd while a writer is moving a node
+    std::atomic<std::size_t>   epoch_   { 0 };
+    mutable ReaderSlot         readers_[ READER_SLOTS ];
+
+    std::mutex                 writerMutex_;
+    std::vector<Node *>        retired_;                                    // unlinked, but possibly still in use by a reader
+
+    // Helper functions
+    const Node * find       ( const Key & key ) const;                      // Lock free search, caller must hold a ReadGuard
+    void         retire     ( Node * node );                                // Schedules node for deletion once no reader can reach it
+    void         synchronize();                                             // Advances the epoch, waits for the readers of the previous epoch, and deletes the retired nodes
+    void         clear      ( Node * node );
+
+    static std::size_t readerSlot();                                        // The calling thread's slot
+  };
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  ConcurrentBinarySearchTree<Key, Value>::Node Definition
+*******************************************************************************/
+template <typename Key, typename Value>
+struct ConcurrentBinarySearchTree<Key, Value>::Node
+{
+  Node( const Key & key, const Value & value, Node * parent )
+    : key_( key ), value_( value ), parent_( parent )
+  {}
+
+  // Immutable once published, safe to read from any thread
+  const Key   key_;
+  const Value value_;
+
+  // Written only by the writer holding the mutex, read by everyone
+  std::atomic<Node *> left_  { nullptr };
+  std::atomic<Node *> right_ { nullptr };
+
+  // Used only by the writer
+  Node * parent_ = nullptr;
+};
+
+
+
+
+/*******************************************************************************
+**  ConcurrentBinarySearchTree<Key, Value>::ReadGuard Definition
+**    Announces the calling thread as a reader in the current epoch for as long as the guard is in scope
+*******************************************************************************/
+template <typename Key, typename Value>
+class ConcurrentBinarySearchTree<Key, Value>::ReadGuard
+{
+  public:
+    ReadGuard( const ConcurrentBinarySearchTree & tree )
+      : counter_( nullptr )
+    {
+      auto & slot = tree.readers_[ readerSlot() ];
+
+      // The writer may advance the epoch between reading it and announcing ourselves in it.  In that case it may have already
+      // stopped waiting for that epoch's readers, so withdraw and announce again in the new epoch.
+      while( true )
+      {
+        auto epoch = tree.epoch_.load();
+        counter_   = &slot.active_[ epoch & 1 ];
+        counter_->fetch_add( 1 );
+
+        if( tree.epoch_.load() == epoch ) break;
+        counter_->fetch_sub( 1 );
+      }
+    }
+
+    ReadGuard            ( const ReadGuard & ) = delete;
+    ReadGuard & operator=( const ReadGuard & ) = delete;
+
+   ~ReadGuard()
+    { counter_->fetch_sub( 1, std::memory_order_release ); }
+
+  private:
+    std::atomic<std::size_t> * counter_;
+};
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  ConcurrentBinarySearchTree<Key, Value>  Definitions
+*******************************************************************************/
+////////////////////////////////////////////////////////////////////////////////
+//   Destructor
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+ConcurrentBinarySearchTree<Key, Value>::~ConcurrentBinarySearchTree()
+{
+  clear( root_.load() );
+  for( auto node : retired_ ) delete node;
+}
+
+
+
+
+template <typename Key, typename Value>
+void ConcurrentBinarySearchTree<Key, Value>::clear( Node * node )
+{
+  if( node == nullptr ) return;
+
+  clear( node->left_ .load() );
+  clear( node->right_.load() );
+
+  delete node;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Search
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+Value ConcurrentBinarySearchTree<Key, Value>::search( const Key & key ) const
+{
+  ReadGuard guard( *this );                                       // the node found stays allocated while the value is copied
+
+  auto node = find( key );
+  if( node == nullptr ) throw std::invalid_argument( "Key not found" );
+  return node->value_;
+}
+
+
+
+
+template <typename Key, typename Value>
+bool ConcurrentBinarySearchTree<Key, Value>::search( const Key & key, Value & value ) const
+{
+  ReadGuard guard( *this );
+
+  auto node = find( key );
+  if( node == nullptr ) return false;
+
+  value = node->value_;
+  return true;
+}
+
+
+
+
+//  zyBook Figure 6.4.1: BST search algorithm, repeated until no writer moved a node while it ran (seqlock read protocol)
+template <typename Key, typename Value>
+const typename ConcurrentBinarySearchTree<Key, Value>::Node * ConcurrentBinarySearchTree<Key, Value>::find( const Key & key ) const
+{
+  while( true )
+  {
+    auto before = version_.load( std::memory_order_acquire );
+    if( before & 1 )                                              // a node is being moved right now
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    auto cur = root_.load( std::memory_order_acquire );
+    while( cur != nullptr  &&  !( key == cur->key_ ) )
+    {
+      cur = ( key < cur->key_ ? cur->left_ : cur->right_ ).load( std::memory_order_acquire );
+    }
+
+    std::atomic_thread_fence( std::memory_order_acquire );        // the reads above happen before the version is checked again
+    if( version_.load( std::memory_order_relaxed ) == before ) return cur;
+  }
+}
+
+
+
+
+template <typename Key, typename Value>
+std::size_t ConcurrentBinarySearchTree<Key, Value>::size() const
+{ return size_.load( std::memory_order_relaxed ); }
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Insert
+////////////////////////////////////////////////////////////////////////////////
+//  zyBook Figure 6.9.1: BSTInsert algorithm.  The new node is fully built before it's published with a single pointer store, so a
+//  reader either sees all of it or none of it.
+template <typename Key, typename Value>
+void ConcurrentBinarySearchTree<Key, Value>::insert( const Key & key, const Value & value )
+{
+  std::lock_guard<std::mutex> lock( writerMutex_ );
+
+  Node *                parent = nullptr;
+  std::atomic<Node *> * link   = &root_;
+
+  for( auto cur = root_.load( std::memory_order_relaxed );  cur != nullptr;  cur = link->load( std::memory_order_relaxed ) )
+  {
+    parent = cur;
+    link   = key < cur->key_ ? &cur->left_ : &cur->right_;        // duplicates descend right
+  }
+
+  link->store( new Node( key, value, parent ), std::memory_order_release );
+  size_.fetch_add( 1, std::memory_order_relaxed );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Remove
+////////////////////////////////////////////////////////////////////////////////
+//  zyBook Figure 6.9.3: BSTRemoveNode algorithm, but the successor node itself is moved into the removed node's place rather than
+//  copying its key and value (which readers may be reading).
+template <typename Key, typename Value>
+void ConcurrentBinarySearchTree<Key, Value>::remove( const Key & key )
+{
+  std::lock_guard<std::mutex> lock( writerMutex_ );
+
+  auto node = root_.load( std::memory_order_relaxed );
+  while( node != nullptr  &&  !( key == node->key_ ) )
+  {
+    node = ( key < node->key_ ? node->left_ : node->right_ ).load( std::memory_order_relaxed );
+  }
+  if( node == nullptr ) return;
+
+  auto linkTo = [this]( Node * parent, Node * child ) -> std::atomic<Node *> &   // the pointer referring to child
+  {
+    if( parent == nullptr ) return root_;
+    return parent->left_.load( std::memory_order_relaxed ) == child ? parent->left_ : parent->right_;
+  };
+
+  auto left  = node->left_ .load( std::memory_order_relaxed );
+  auto right = node->right_.load( std::memory_order_relaxed );
+
+  if( left == nullptr  ||  right == nullptr )
+  {
+    // At most one child:  splice it in.  A reader standing on node still continues into the same child, so no version change.
+    auto child = left != nullptr ? left : right;
+    if( child != nullptr ) child->parent_ = node->parent_;
+    linkTo( node->parent_, node ).store( child, std::memory_order_release );
+  }
+
+  else
+  {
+    // Two children:  the successor (leftmost of the right subtree) leaves its place and takes node's.  A reader looking for the
+    // successor's key may miss it while it moves, so readers are told to retry.
+    auto successor = right;
+    while( auto next = successor->left_.load( std::memory_order_relaxed ) ) successor = next;
+
+    version_.store( version_.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );    // odd:  moving
+    std::atomic_thread_fence( std::memory_order_release );
+
+    if( successor != right )
+    {
+      auto successorRight = successor->right_.load( std::memory_order_relaxed );
+      if( successorRight != nullptr ) successorRight->parent_ = successor->parent_;
+      successor->parent_->left_.store( successorRight, std::memory_order_release );
+
+      successor->right_.store( right, std::memory_order_release );
+      right->parent_ = successor;
+    }
+
+    successor->left_.store( left, std::memory_order_release );
+    left->parent_      = successor;
+    successor->parent_ = node->parent_;
+    linkTo( node->parent_, node ).store( successor, std::memory_order_release );
+
+    version_.store( version_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );    // even:  done
+  }
+
+  size_.fetch_sub( 1, std::memory_order_relaxed );
+  retire( node );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Memory reclamation
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+void ConcurrentBinarySearchTree<Key, Value>::retire( Node * node )
+{
+  retired_.push_back( node );
+  if( retired_.size() >= RECLAIM_BATCH ) synchronize();
+}
+
+
+
+
+//  Every retired node was unlinked before the epoch advances, so a reader entering the new epoch can't reach any of them.  Once the
+//  readers still in the previous epoch have left, nobody can.
+template <typename Key, typename Value>
+void ConcurrentBinarySearchTree<Key, Value>::synchronize()
+{
+  auto previous = epoch_.load();
+  epoch_.store( previous + 1 );
+
+  for( auto & slot : readers_ )
+  {
+    while( slot.active_[ previous & 1 ].load() != 0 ) std::this_thread::yield();   // sequentially consistent, pairs with ReadGuard's recheck
+  }
+
+  for( auto node : retired_ ) delete node;
+  retired_.clear();
+}
+
+
+
+
+template <typename Key, typename Value>
+std::size_t ConcurrentBinarySearchTree<Key, Value>::readerSlot()
+{
+  static std::atomic<std::size_t> nextSlot { 0 };
+  thread_local std::size_t        slot = nextSlot.fetch_add( 1, std::memory_order_relaxed ) % READER_SLOTS;
+
+  return slot;
+}
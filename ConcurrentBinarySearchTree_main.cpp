@@ -0,0 +1,93 @@
+#include <algorithm>  // shuffle()
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <numeric>    // iota()
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentBinarySearchTree.hpp"
+
+
+
+
+namespace    // anonymous
+{
+  // Every thread performs a mix of 99% searches and 1% updates for a fixed amount of time.  Returns the operations completed per second.
+  double measureThroughput( ConcurrentBinarySearchTree<unsigned, unsigned> & tree, unsigned nKeys, unsigned nThreads )
+  {
+    using namespace std::chrono_literals;
+
+    std::atomic<bool>          stop     { false };
+    std::atomic<unsigned long> totalOps { 0 };
+    std::vector<std::thread>   threads;
+
+    for( unsigned t = 0;  t < nThreads;  ++t )
+    {
+      threads.emplace_back( [&, t]
+      {
+        std::mt19937  random( t );
+        unsigned long ops      = 0;
+        unsigned      value    = 0;
+        unsigned      extraKey = nKeys + t;                           // each thread inserts and removes its own key, so updates never collide
+
+        while( !stop.load( std::memory_order_relaxed ) )
+        {
+          if( ++ops % 100 == 0 )
+          {
+            if( ops % 200 == 0 ) tree.remove( extraKey );
+            else                 tree.insert( extraKey, extraKey );
+          }
+          else tree.search( random() % nKeys, value );
+        }
+
+        totalOps += ops;
+      } );
+    }
+
+    std::this_thread::sleep_for( 250ms );
+    stop = true;
+    for( auto & thread : threads ) thread.join();
+
+    return totalOps / 0.25;
+  }
+}    // anonymous namespace
+
+
+
+int main()
+{
+  ConcurrentBinarySearchTree<std::string, double> studentGrades;
+  studentGrades.insert( "Ricardo", 2.5  );
+  studentGrades.insert( "Ellen",   3.5  );
+  studentGrades.insert( "Chen",    2.5  );
+  studentGrades.insert( "Kevin",   3.25 );
+  studentGrades.insert( "Kumar",   3.05 );
+
+  studentGrades.remove( "Ellen" );                                      // two children, Kevin moves into Ellen's place
+  if( studentGrades.size() != 4  ||  studentGrades.search( "Kumar" ) != 3.05 ) std::cerr << "Concurrent tree contents do not match expected\n";
+
+
+  // Read throughput as the number of threads grows.  Keys are inserted in random order so the (unbalanced) tree stays shallow.
+  constexpr unsigned N = 1'000'000;
+  std::vector<unsigned> keys( N );
+  std::iota   ( keys.begin(), keys.end(), 0U );
+  std::shuffle( keys.begin(), keys.end(), std::mt19937( 131 ) );
+
+  ConcurrentBinarySearchTree<unsigned, unsigned> tree;
+  for( auto key : keys ) tree.insert( key, key );
+
+  auto maxThreads = std::max( 1U, std::thread::hardware_concurrency() );
+  for( unsigned nThreads = 1;  nThreads <= maxThreads;  nThreads *= 2 )
+  {
+    std::cout << nThreads << " thread(s): " << measureThroughput( tree, N, nThreads ) / 1e6 << " million operations per second\n";
+  }
+}
+
+
+
+// Explicit instantiation - a technique to ensure all functions of the template are created and semantically checked.  By default,
+// only functions called get instantiated so you won't know it has compile errors until you actually call it.
+template class ConcurrentBinarySearchTree<unsigned, float>;
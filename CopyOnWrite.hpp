@@ -0,0 +1,445 @@
+#pragma once
+
+#include <atomic>                                                         // atomic_thread_fence()
+#include <cstddef>                                                        // size_t
+#include <memory>                                                         // shared_ptr, make_shared()
+#include <stdexcept>                                                      // range_error
+#include <type_traits>                                                    // remove_reference
+#include <utility>                                                        // move(), forward(), declval(), exchange()
+
+
+
+
+// Template Class Definition
+//   Opt-in copy-on-write for ExtendableVector, FixedVector, or SmallVector.  Copies of a CopyOnWrite<Vector> share one reference
+//   counted Vector, so copying, passing by value, and assigning are O(1) whatever the size.  The first mutating call on a copy that
+//   is still shared - push_back, set, insert, erase, clear, or any non-const element access - makes the real copy first, so changes
+//   are never seen through the other copies.
+//
+//   Reading without copying has to go through a const CopyOnWrite (a const reference, or std::as_const()), as the non-const at(),
+//   operator[], begin(), end(), emplace_back(), and the mutators returning pointers hand out writable elements and so must copy a
+//   shared vector first.  Such a reference could still be written through after a later copy, so, as copy-on-write strings did, once
+//   one has been handed out the vector is never shared again:  copying or assigning from it makes the real copy straight away.  Const
+//   pointers obtained from a copy still refer to the shared elements until that copy is changed.  Copies may be used from different
+//   threads, but like the vectors a single CopyOnWrite object must not be changed by one thread while another uses it.
+template<typename Vector>
+class CopyOnWrite
+{
+  public:
+    using Element = std::remove_reference_t<decltype( *std::declval<Vector &>().begin() )>;
+
+    // Constructors, destructor, and assignments.  Copies and assignments share the vector unless writable elements of it have been
+    // handed out, moves leave other empty
+    CopyOnWrite();
+    explicit CopyOnWrite( std::size_t capacity );
+    explicit CopyOnWrite( Vector      vector   );                         // Takes over vector's elements
+
+    CopyOnWrite            ( const CopyOnWrite &  other );
+    CopyOnWrite            (       CopyOnWrite && other ) noexcept;
+    CopyOnWrite & operator=( const CopyOnWrite &  rhs   );
+    CopyOnWrite & operator=(       CopyOnWrite && rhs   ) noexcept;
+
+    // Queries, none of which copy a shared vector
+    const Element & at        ( std::size_t index ) const;                // Checks bounds, throws std::range_error
+    const Element & operator[]( std::size_t index ) const;                // No bounds checking
+
+    std::size_t size    () const;
+    bool        empty   () const;
+    bool        isShared() const;                                         // True while another copy shares this vector
+
+
+    // Element access that copies a shared vector first
+    Element &   at        ( std::size_t index );                          // Checks bounds, throws std::range_error
+    Element &   operator[]( std::size_t index );                          // No bounds checking
+
+
+    // Iterators.  The const ones don't copy a shared vector, the others do
+    const Element * begin () const;
+    const Element * end   () const;
+    const Element * cbegin() const;
+    const Element * cend  () const;
+    Element *       begin ();
+    Element *       end   ();
+
+
+    // Mutators, each copies a shared vector first and then does just what Vector's does
+    void push_back( const Element & value );
+    void push_back(       Element && value );
+    template <typename... Args>
+    Element & emplace_back( Args &&... args );
+
+    std::size_t erase( std::size_t index    );
+    Element *   erase( Element *   position );                            // position may refer to the shared vector's elements
+    std::size_t erase( std::size_t first, std::size_t last );
+    Element *   erase( Element *   first, Element *   last );             // first and last may refer to the shared vector's elements
+
+    template <typename Predicate>
+    std::size_t erase_if( Predicate predicate );
+
+    void set( std::size_t index, const Element & value );
+    void set( std::size_t index,      Element && value );
+
+    std::size_t insert( std::size_t beforeIndex,    const Element & value );
+    Element *   insert( Element *   beforePosition, const Element & value );
+    std::size_t insert( std::size_t beforeIndex,         Element && value );
+    Element *   insert( Element *   beforePosition,      Element && value );
+
+    template <typename... Args>
+    std::size_t emplace( std::size_t beforeIndex,    Args &&... args );
+    template <typename... Args>
+    Element *   emplace( Element *   beforePosition, Args &&... args );
+
+    template <typename InputIterator>
+    std::size_t insert( std::size_t beforeIndex,    InputIterator first, InputIterator last );
+    template <typename InputIterator>
+    Element *   insert( Element *   beforePosition, InputIterator first, InputIterator last );
+    template <typename InputIterator>
+    void        append( InputIterator first, InputIterator last );
+
+    void clear();
+
+
+  private:
+    std::shared_ptr<Vector> _shared;                                      // the vector, shared by every copy until one changes it.  Empty once moved from
+    bool                    _unshareable = false;                         // a writable element has been handed out, so copies can't share the vector
+
+    Vector &    unshared   ();                                            // helper function to make the real copy if the vector is shared
+    Vector &    unshareable();                                            // unshared(), then marks the vector as never to be shared again
+    std::shared_ptr<Vector> shareable() const;                            // what a copy of this CopyOnWrite holds, _shared or a real copy of it
+    std::size_t indexOf ( const Element * position ) const;               // position's index, found before unshared() moves the elements
+};
+
+
+
+
+
+
+// Implementation
+
+template <typename Vector>
+CopyOnWrite<Vector>::CopyOnWrite()
+  : _shared( std::make_shared<Vector>() )
+{}
+
+
+
+template <typename Vector>
+CopyOnWrite<Vector>::CopyOnWrite( std::size_t capacity )
+  : _shared( std::make_shared<Vector>( capacity ) )
+{}
+
+
+
+template <typename Vector>
+CopyOnWrite<Vector>::CopyOnWrite( Vector vector )
+  : _shared( std::make_shared<Vector>( std::move( vector ) ) )
+{}
+
+
+
+template <typename Vector>
+CopyOnWrite<Vector>::CopyOnWrite( const CopyOnWrite & other )
+  : _shared( other.shareable() )
+{}
+
+
+
+template <typename Vector>
+CopyOnWrite<Vector>::CopyOnWrite( CopyOnWrite && other ) noexcept
+  : _shared     ( std::move( other._shared ) ),
+    _unshareable( std::exchange( other._unshareable, false ) )
+{}
+
+
+
+template <typename Vector>
+CopyOnWrite<Vector> & CopyOnWrite<Vector>::operator=( const CopyOnWrite & rhs )
+{
+  if( this != &rhs )
+  {
+    _shared      = rhs.shareable();
+    _unshareable = false;
+  }
+  return *this;
+}
+
+
+
+template <typename Vector>
+CopyOnWrite<Vector> & CopyOnWrite<Vector>::operator=( CopyOnWrite && rhs ) noexcept
+{
+  _shared      = std::move( rhs._shared );
+  _unshareable = std::exchange( rhs._unshareable, false );
+  return *this;
+}
+
+
+
+// A vector whose elements have been handed out for writing is copied for real, as a write through one of them must not reach the copy
+template <typename Vector>
+std::shared_ptr<Vector> CopyOnWrite<Vector>::shareable() const
+{ return _unshareable ? std::make_shared<Vector>( *_shared ) : _shared; }
+
+
+
+// A vector no one else holds can be changed in place.  Other copies that have just let go of it may still have been reading it, so
+// the acquire fence makes sure their reads are finished before this copy writes
+template <typename Vector>
+Vector & CopyOnWrite<Vector>::unshared()
+{
+  if     ( _shared == nullptr       ) _shared = std::make_shared<Vector>();              // moved from
+  else if( _shared.use_count() > 1  ) _shared = std::make_shared<Vector>( *_shared );    // the real copy
+  else                                std::atomic_thread_fence( std::memory_order_acquire );
+
+  return *_shared;
+}
+
+
+
+template <typename Vector>
+Vector & CopyOnWrite<Vector>::unshareable()
+{
+  auto & vector = unshared();
+  _unshareable  = true;
+  return vector;
+}
+
+
+
+template <typename Vector>
+std::size_t CopyOnWrite<Vector>::indexOf( const Element * position ) const
+{ return static_cast<std::size_t>( position - cbegin() ); }              // Note the pointer arithmetic here
+
+
+
+template <typename Vector>
+std::size_t CopyOnWrite<Vector>::size() const
+{ return _shared == nullptr ? 0 : _shared->size(); }
+
+
+
+template <typename Vector>
+bool CopyOnWrite<Vector>::empty() const
+{ return size() == 0; }
+
+
+
+template <typename Vector>
+bool CopyOnWrite<Vector>::isShared() const
+{ return _shared.use_count() > 1; }
+
+
+
+template <typename Vector>
+const typename CopyOnWrite<Vector>::Element & CopyOnWrite<Vector>::at( std::size_t index ) const
+{
+  if( index >= size() ) throw std::range_error( "index out of bounds" );
+
+  return ( *_shared )[index];
+}
+
+
+
+template <typename Vector>
+const typename CopyOnWrite<Vector>::Element & CopyOnWrite<Vector>::operator[]( std::size_t index ) const
+{ return ( *_shared )[index]; }                                           // Note: array bounds intentionally not checked
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element & CopyOnWrite<Vector>::at( std::size_t index )
+{
+  if( index >= size() ) throw std::range_error( "index out of bounds" );
+
+  return unshareable()[index];
+}
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element & CopyOnWrite<Vector>::operator[]( std::size_t index )
+{ return unshareable()[index]; }                                          // Note: array bounds intentionally not checked
+
+
+
+template <typename Vector>
+const typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::begin() const
+{ return _shared == nullptr ? nullptr : _shared->begin(); }
+
+
+
+template <typename Vector>
+const typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::end() const
+{ return _shared == nullptr ? nullptr : _shared->end(); }
+
+
+
+template <typename Vector>
+const typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::cbegin() const
+{ return begin(); }
+
+
+
+template <typename Vector>
+const typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::cend() const
+{ return end(); }
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::begin()
+{ return unshareable().begin(); }
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::end()
+{ return unshareable().end(); }
+
+
+
+template <typename Vector>
+void CopyOnWrite<Vector>::push_back( const Element & value )
+{ unshared().push_back( value ); }
+
+
+
+template <typename Vector>
+void CopyOnWrite<Vector>::push_back( Element && value )
+{ unshared().push_back( std::move( value ) ); }
+
+
+
+template <typename Vector>
+template <typename... Args>
+typename CopyOnWrite<Vector>::Element & CopyOnWrite<Vector>::emplace_back( Args &&... args )
+{ return unshareable().emplace_back( std::forward<Args>( args )... ); }
+
+
+
+template <typename Vector>
+std::size_t CopyOnWrite<Vector>::erase( std::size_t index )
+{ return unshared().erase( index ); }
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::erase( Element * position )
+{
+  // delegate to delete by index, position may be about to be copied away from
+  auto index = indexOf( position );
+  return begin() + erase( index );
+}
+
+
+
+template <typename Vector>
+std::size_t CopyOnWrite<Vector>::erase( std::size_t first, std::size_t last )
+{ return unshared().erase( first, last ); }
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::erase( Element * first, Element * last )
+{
+  // delegate to delete by index, first and last may be about to be copied away from
+  auto firstIndex = indexOf( first );
+  auto lastIndex  = indexOf( last  );
+  return begin() + erase( firstIndex, lastIndex );
+}
+
+
+
+template <typename Vector>
+template <typename Predicate>
+std::size_t CopyOnWrite<Vector>::erase_if( Predicate predicate )
+{ return unshared().erase_if( predicate ); }
+
+
+
+template <typename Vector>
+void CopyOnWrite<Vector>::set( std::size_t index, const Element & value )
+{ unshared().set( index, value ); }
+
+
+
+template <typename Vector>
+void CopyOnWrite<Vector>::set( std::size_t index, Element && value )
+{ unshared().set( index, std::move( value ) ); }
+
+
+
+template <typename Vector>
+std::size_t CopyOnWrite<Vector>::insert( std::size_t beforeIndex, const Element & value )
+{ return unshared().insert( beforeIndex, value ); }
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::insert( Element * beforePosition, const Element & value )
+{
+  auto index = indexOf( beforePosition );
+  return begin() + insert( index, value );
+}
+
+
+
+template <typename Vector>
+std::size_t CopyOnWrite<Vector>::insert( std::size_t beforeIndex, Element && value )
+{ return unshared().insert( beforeIndex, std::move( value ) ); }
+
+
+
+template <typename Vector>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::insert( Element * beforePosition, Element && value )
+{
+  auto index = indexOf( beforePosition );
+  return begin() + insert( index, std::move( value ) );
+}
+
+
+
+template <typename Vector>
+template <typename... Args>
+std::size_t CopyOnWrite<Vector>::emplace( std::size_t beforeIndex, Args &&... args )
+{ return unshared().emplace( beforeIndex, std::forward<Args>( args )... ); }
+
+
+
+template <typename Vector>
+template <typename... Args>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::emplace( Element * beforePosition, Args &&... args )
+{
+  auto index = indexOf( beforePosition );
+  return begin() + emplace( index, std::forward<Args>( args )... );
+}
+
+
+
+template <typename Vector>
+template <typename InputIterator>
+std::size_t CopyOnWrite<Vector>::insert( std::size_t beforeIndex, InputIterator first, InputIterator last )
+{ return unshared().insert( beforeIndex, first, last ); }
+
+
+
+template <typename Vector>
+template <typename InputIterator>
+typename CopyOnWrite<Vector>::Element * CopyOnWrite<Vector>::insert( Element * beforePosition, InputIterator first, InputIterator last )
+{
+  auto index = indexOf( beforePosition );
+  return begin() + insert( index, first, last );
+}
+
+
+
+template <typename Vector>
+template <typename InputIterator>
+void CopyOnWrite<Vector>::append( InputIterator first, InputIterator last )
+{ unshared().append( first, last ); }
+
+
+
+template <typename Vector>
+void CopyOnWrite<Vector>::clear()
+{ unshared().clear(); }
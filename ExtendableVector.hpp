@@ -1,21 +1,39 @@
 #pragma once
 
-#include <algorithm>                                                      // move(), move_backward(), copy()
-#include <cstddef>                                                        // size_t
+#include <algorithm>                                                      // move(), move_backward(), copy(), min(), max(), rotate(), remove_if()
+#include <cstddef>                                                        // size_t, max_align_t
+#include <cstdlib>                                                        // malloc(), realloc(), free()
+#include <iterator>                                                       // iterator_traits, distance()
+#include <memory>                                                         // allocator, uninitialized_copy_n(), uninitialized_copy(), uninitialized_move(), destroy()
+#include <new>                                                            // placement new, bad_alloc
 #include <stdexcept>                                                      // range_error
+#include <type_traits>                                                    // is_trivially_copyable, is_base_of
+#include <utility>                                                        // forward(), exchange()
+
+
+
+
+// Growth policies, how much capacity a full vector adds
+//   DOUBLE          - capacity doubles.  Fewest reallocations, but up to half the memory may be unused
+//   ONE_AND_A_HALF  - capacity grows by half.  Less memory unused, at the cost of more reallocations
+//   FIXED_CHUNK     - capacity grows by GROWTH_CHUNK bytes worth of elements.  Least memory unused, but growth is O(n) each time
+//                     unless the elements are relocated with realloc() and the block can be extended (or remapped) in place
+enum class GrowthPolicy { DOUBLE, ONE_AND_A_HALF, FIXED_CHUNK };
 
 
 
 
 // Template Class Definition
-template<typename T>
+template<typename T, GrowthPolicy Growth = GrowthPolicy::DOUBLE>
 class ExtendableVector
 {
   public:
     // Constructors, destructor, and assignments
     ExtendableVector            ( std::size_t capacity = 64      );       // power of 2, but nothing special about 2^6
     ExtendableVector            ( const ExtendableVector & other );       // Copy constructor
+    ExtendableVector            (       ExtendableVector && other ) noexcept;   // Move constructor, takes over other's array leaving other empty
     ExtendableVector & operator=( const ExtendableVector & rhs   );       // Copy assignment
+    ExtendableVector & operator=(       ExtendableVector && rhs  ) noexcept;    // Move assignment
    ~ExtendableVector            ();
 
     // Queries
@@ -33,14 +51,38 @@ class ExtendableVector
 
     // Mutators
     void push_back( const T & value );                                    // Checks capacity, throws std::range_error
+    void push_back(       T && value );                                   // Checks capacity, throws std::range_error
+    template <typename... Args>
+    T &  emplace_back( Args &&... args );                                 // Constructs the new element in place from args.  Checks capacity, throws std::range_error
 
     std::size_t erase( std::size_t index    );                            // Checks bounds, throws std::range_error
     T *         erase( T *         position );                            // Checks bounds, throws std::range_error
+    std::size_t erase( std::size_t first, std::size_t last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+    T *         erase( T *         first, T *         last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+
+    template <typename Predicate>
+    std::size_t erase_if( Predicate predicate );                          // Removes every element predicate( element ) is true for in a single pass.  Returns the number removed
 
     void set( std::size_t index, const T & value );                       // Checks bounds, throws std::range_error
+    void set( std::size_t index,      T && value );                       // Checks bounds, throws std::range_error
 
     std::size_t insert( std::size_t beforeIndex,    const T & value );    // Checks capacity, throws std::range_error
     T *         insert( T *         beforePosition, const T & value );    // Checks capacity, throws std::range_error
+    std::size_t insert( std::size_t beforeIndex,         T && value );    // Checks capacity, throws std::range_error
+    T *         insert( T *         beforePosition,      T && value );    // Checks capacity, throws std::range_error
+
+    template <typename... Args>
+    std::size_t emplace( std::size_t beforeIndex,    Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+    template <typename... Args>
+    T *         emplace( T *         beforePosition, Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+
+    // Inserts copies of [first, last), which must not refer to this vector's elements, shifting the elements after them only once
+    template <typename InputIterator>
+    std::size_t insert( std::size_t beforeIndex,    InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    T *         insert( T *         beforePosition, InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    void        append( InputIterator first, InputIterator last );       // Checks capacity, throws std::range_error
 
     void clear();
 
@@ -50,7 +92,16 @@ class ExtendableVector
     std::size_t _capacity = 0;                                            // length of the array
     T *         _array    = nullptr;                                      // pointer to dynamically allocated array
 
-    void reserve( size_t newCapacity );                                   // helper function to change capacity
+    void        reserve       ( size_t newCapacity );                     // helper function to change capacity
+    std::size_t grownCapacity () const;                                   // the capacity after the next growth, according to the growth policy
+
+    // Trivially copyable elements can be relocated as raw bytes, so their storage comes from malloc() and grows with realloc(), which
+    // avoids copying entirely when the block can be extended in place.  Large blocks are remapped rather than copied by most allocators
+    static constexpr bool RELOCATE_BY_REALLOC = std::is_trivially_copyable_v<T>  &&  alignof( T ) <= alignof( std::max_align_t );
+    static constexpr std::size_t GROWTH_CHUNK = 1 << 20;                  // bytes added per growth by GrowthPolicy::FIXED_CHUNK
+
+    static T *  allocate  ( std::size_t capacity );                       // raw, uninitialized storage for capacity elements
+    static void deallocate( T * array, std::size_t capacity );
 };
 
 
@@ -61,39 +112,39 @@ class ExtendableVector
 // Implementation
 
 // Constructor with initial capacity argument
-template<typename T>
-ExtendableVector<T>::ExtendableVector( std::size_t capacity )
-  : _size( 0 ), _capacity( capacity ), _array( new T[capacity]() )
-{}
+template<typename T, GrowthPolicy Growth>
+ExtendableVector<T, Growth>::ExtendableVector( std::size_t capacity )
+  : _size( 0 ), _capacity( capacity ), _array( allocate( capacity ) )
+{}                                                                        // storage only, no elements are constructed until added
 
 
 
-template <typename T>
-std::size_t ExtendableVector<T>::size()
+template <typename T, GrowthPolicy Growth>
+std::size_t ExtendableVector<T, Growth>::size()
 { return _size; }
 
 
 
-template <typename T>
-bool ExtendableVector<T>::empty()
+template <typename T, GrowthPolicy Growth>
+bool ExtendableVector<T, Growth>::empty()
 { return _size == 0; }
 
 
 
-template <typename T>
-T * ExtendableVector<T>::begin()
+template <typename T, GrowthPolicy Growth>
+T * ExtendableVector<T, Growth>::begin()
 { return _array; }
 
 
 
-template <typename T>
-T * ExtendableVector<T>::end()
+template <typename T, GrowthPolicy Growth>
+T * ExtendableVector<T, Growth>::end()
 { return _array + _size; }                                                // Note the pointer arithmetic used
 
 
 
-template <typename T>
-void ExtendableVector<T>::clear()
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::clear()
 {
   // destroy the elements held allowing resources to be released.  But maintain "this" ExtendableVector's capacity
   while( _size != 0 ) _array[--_size].~T();                               // Direct call to destructor
@@ -101,8 +152,8 @@ void ExtendableVector<T>::clear()
 
 
 
-template <typename T>
-T & ExtendableVector<T>::at( std::size_t index )
+template <typename T, GrowthPolicy Growth>
+T & ExtendableVector<T, Growth>::at( std::size_t index )
 {
   if( index >= _size ) throw std::range_error( "index out of bounds" );
 
@@ -111,43 +162,62 @@ T & ExtendableVector<T>::at( std::size_t index )
 
 
 
-template <typename T>
-void ExtendableVector<T>::push_back( const T & value )
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::push_back( const T & value )
 { insert( _size, value ); }                                               // delegate to insert() leveraging error checking
 
 
 
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::push_back( T && value )
+{ insert( _size, std::move( value ) ); }                                  // delegate to insert() leveraging error checking
+
+
+
+template <typename T, GrowthPolicy Growth>
+template <typename... Args>
+T & ExtendableVector<T, Growth>::emplace_back( Args &&... args )
+{ return _array[ emplace( _size, std::forward<Args>( args )... ) ]; }     // delegate to emplace() leveraging error checking
+
+
+
 // Overloaded Array-Access Operator
-template <typename T>
-T & ExtendableVector<T>::operator[]( std::size_t index )
+template <typename T, GrowthPolicy Growth>
+T & ExtendableVector<T, Growth>::operator[]( std::size_t index )
 { return _array[ index ]; }                                               // Note: array bounds intentionally not checked
 
 
 
-template <typename T>
-void ExtendableVector<T>::set( std::size_t index, const T & value )
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::set( std::size_t index, const T & value )
 { at( index ) = value; }                                                  // delegate to at() leveraging error checking
 
 
 
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::set( std::size_t index, T && value )
+{ at( index ) = std::move( value ); }                                     // delegate to at() leveraging error checking
+
+
+
 // Removes element from position. Elements from higher positions are shifted back to fill gap.
 // Vector size decrements
-template <typename T>
-std::size_t ExtendableVector<T>::erase( std::size_t index )
+template <typename T, GrowthPolicy Growth>
+std::size_t ExtendableVector<T, Growth>::erase( std::size_t index )
 {
   if( index >= _size ) throw std::range_error( "index out of bounds" );
 
   // shift elements to the left and decrement the number of elements in the container
   std::move( _array + index + 1, _array + _size, _array + index );        // Note the pointer arithmetic here
-  --_size;
+  _array[--_size].~T();                                                   // the last slot now holds a moved-from element
 
   return index;
 }
 
 
 
-template <typename T>
-T * ExtendableVector<T>::erase( T * position )
+template <typename T, GrowthPolicy Growth>
+T * ExtendableVector<T, Growth>::erase( T * position )
 {
   // delegate to delete by index
   auto index = position - begin();                                        // Note the pointer arithmetic here
@@ -157,17 +227,91 @@ T * ExtendableVector<T>::erase( T * position )
 
 
 
+template <typename T, GrowthPolicy Growth>
+std::size_t ExtendableVector<T, Growth>::erase( std::size_t first, std::size_t last )
+{
+  if( first > last  ||  last > _size ) throw std::range_error( "index out of bounds" );
+
+  // shift the elements after the range left once, then destroy the moved-from elements left at the end
+  std::move( _array + last, _array + _size, _array + first );             // Note the pointer arithmetic here
+  std::destroy( _array + _size - ( last - first ), _array + _size );
+  _size -= last - first;
+
+  return first;
+}
+
+
+
+template <typename T, GrowthPolicy Growth>
+T * ExtendableVector<T, Growth>::erase( T * first, T * last )
+{
+  // delegate to delete by index
+  erase( first - begin(), last - begin() );                               // Note the pointer arithmetic here
+  return first;
+}
+
+
+
+// Keeps the elements predicate is false for in their original order, each moved at most once
+template <typename T, GrowthPolicy Growth>
+template <typename Predicate>
+std::size_t ExtendableVector<T, Growth>::erase_if( Predicate predicate )
+{
+  auto kept    = std::remove_if( begin(), end(), predicate );
+  auto removed = static_cast<std::size_t>( end() - kept );
+
+  std::destroy( kept, end() );
+  _size -= removed;
+
+  return removed;
+}
+
+
+
 // Copies x to element at position. Items at that position and higher are shifted over to make room. Vector size increments.
-template <typename T>
-std::size_t ExtendableVector<T>::insert( std::size_t beforeIndex, const T & value )
+template <typename T, GrowthPolicy Growth>
+std::size_t ExtendableVector<T, Growth>::insert( std::size_t beforeIndex, const T & value )
+{ return emplace( beforeIndex, value ); }
+
+
+
+template <typename T, GrowthPolicy Growth>
+std::size_t ExtendableVector<T, Growth>::insert( std::size_t beforeIndex, T && value )
+{ return emplace( beforeIndex, std::move( value ) ); }
+
+
+
+// Constructs a new element from args at position.  Items at that position and higher are shifted over to make room.  Vector size
+// increments.
+template <typename T, GrowthPolicy Growth>
+template <typename... Args>
+std::size_t ExtendableVector<T, Growth>::emplace( std::size_t beforeIndex, Args &&... args )
 {
-  if( _size >= _capacity ) reserve( 2 * _capacity );                      // If at max capacity, double the capacity
   if( beforeIndex > _size ) beforeIndex = _size;                          // insert at the back
 
-  // move elements to create space starting from the right and working left
-  std::move_backward( _array + beforeIndex, _array + _size, _array + _size + 1 );    // Note the pointer arithmetic here
+  if( beforeIndex == _size  &&  _size < _capacity )
+  {
+    new( _array + _size ) T( std::forward<Args>( args )... );             // construct directly in the raw slot past the end
+    return _size++;
+  }
+
+  // args may refer to an element of this vector, so the new element is made before anything moves
+  T element( std::forward<Args>( args )... );
+  if( _size >= _capacity ) reserve( grownCapacity() );                    // If at max capacity, grow according to the growth policy
+
+  if( beforeIndex == _size )
+  {
+    new( _array + _size ) T( std::move( element ) );
+  }
+  else
+  {
+    // The raw slot past the end is constructed from the last element, then the remaining elements move to create space starting from
+    // the right and working left
+    new( _array + _size ) T( std::move( _array[ _size - 1 ] ) );
+    std::move_backward( _array + beforeIndex, _array + _size - 1, _array + _size );   // Note the pointer arithmetic here
 
-  _array[ beforeIndex ] = value;                                          // make a copy of the element in the empty slot
+    _array[ beforeIndex ] = std::move( element );                         // move the new element into the vacated slot
+  }
   ++_size;
 
   return beforeIndex;
@@ -175,26 +319,127 @@ std::size_t ExtendableVector<T>::insert( std::size_t beforeIndex, const T & valu
 
 
 
-template <typename T>
-T* ExtendableVector<T>::insert( T * beforePosition, const T & value )
+template <typename T, GrowthPolicy Growth>
+T* ExtendableVector<T, Growth>::insert( T * beforePosition, const T & value )
 {
   auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
   insert( index, value );
-  return beforePosition;
+  return begin() + index;                                                 // the array may have moved
 }
 
 
 
-template <typename T>
-void ExtendableVector<T>::reserve( std::size_t newCapacity )
+template <typename T, GrowthPolicy Growth>
+T* ExtendableVector<T, Growth>::insert( T * beforePosition, T && value )
 {
-  if( newCapacity > _capacity )
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, std::move( value ) );
+  return begin() + index;
+}
+
+
+
+template <typename T, GrowthPolicy Growth>
+template <typename... Args>
+T* ExtendableVector<T, Growth>::emplace( T * beforePosition, Args &&... args )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  emplace( index, std::forward<Args>( args )... );
+  return begin() + index;
+}
+
+
+
+// The new elements are appended in one pass, then a single rotation moves them into place shifting the elements after them
+template <typename T, GrowthPolicy Growth>
+template <typename InputIterator>
+std::size_t ExtendableVector<T, Growth>::insert( std::size_t beforeIndex, InputIterator first, InputIterator last )
+{
+  if( beforeIndex > _size ) beforeIndex = _size;                          // insert at the back
+
+  auto oldSize = _size;
+  append( first, last );
+  std::rotate( _array + beforeIndex, _array + oldSize, _array + _size );  // Note the pointer arithmetic here
+
+  return beforeIndex;
+}
+
+
+
+template <typename T, GrowthPolicy Growth>
+template <typename InputIterator>
+T* ExtendableVector<T, Growth>::insert( T * beforePosition, InputIterator first, InputIterator last )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, first, last );
+  return begin() + index;                                                 // the array may have moved
+}
+
+
+
+// When the range can be measured up front, room for all of it is made at once.  Otherwise elements are added one at a time.  Either
+// way, if adding an element fails the elements already added are removed again
+template <typename T, GrowthPolicy Growth>
+template <typename InputIterator>
+void ExtendableVector<T, Growth>::append( InputIterator first, InputIterator last )
+{
+  using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  if constexpr( std::is_base_of_v<std::forward_iterator_tag, Category> )
+  {
+    auto count = static_cast<std::size_t>( std::distance( first, last ) );
+    if( _size + count > _capacity ) reserve( std::max( _size + count, grownCapacity() ) );   // at most one reallocation
+
+    std::uninitialized_copy( first, last, _array + _size );              // destroys the copies already made if one throws
+    _size += count;
+  }
+  else
   {
-    T * newArray = new T[newCapacity]();
-    // Move values to new array
-    std::move( _array, _array + _size, newArray );
+    auto oldSize = _size;
+    try
+    {
+      for( ;  first != last;  ++first ) emplace_back( *first );
+    }
+    catch( ... )
+    {
+      std::destroy( _array + oldSize, _array + _size );
+      _size = oldSize;
+      throw;
+    }
+  }
+}
 
-    delete[] _array;
+
+
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::reserve( std::size_t newCapacity )
+{
+  if( newCapacity <= _capacity ) return;
+
+  if constexpr( RELOCATE_BY_REALLOC )
+  {
+    auto newArray = static_cast<T *>( std::realloc( _array, newCapacity * sizeof( T ) ) );
+    if( newArray == nullptr ) throw std::bad_alloc();
+
+    _array    = newArray;
+    _capacity = newCapacity;
+  }
+  else
+  {
+    T * newArray = allocate( newCapacity );
+    // Move construct values into the new array's raw storage, then destroy the moved-from originals
+    try
+    {
+      std::uninitialized_move( _array, _array + _size, newArray );
+    }
+    catch( ... )
+    {
+      deallocate( newArray, newCapacity );
+      throw;
+    }
+
+    std::destroy( _array, _array + _size );
+    deallocate( _array, _capacity );
     _array    = newArray;
     _capacity = newCapacity;
   }
@@ -203,26 +448,44 @@ void ExtendableVector<T>::reserve( std::size_t newCapacity )
 
 
 // Copy Constructor
-template <typename T>
-ExtendableVector<T>::ExtendableVector( const ExtendableVector<T> & other )
-: _size( other._size ), _capacity( other._capacity ), _array( new T[other._capacity]() )
+template <typename T, GrowthPolicy Growth>
+ExtendableVector<T, Growth>::ExtendableVector( const ExtendableVector<T, Growth> & other )
+: _size( 0 ), _capacity( other._capacity ), _array( allocate( other._capacity ) )
 {
-  // Copy each element from the other vector to this vector
-  std::copy_n( other._array, other._size, _array );
+  // Copy construct each element from the other vector into this vector's raw storage
+  try
+  {
+    std::uninitialized_copy_n( other._array, other._size, _array );
+    _size = other._size;
+  }
+  catch( ... )
+  {
+    deallocate( _array, _capacity );                                      // the destructor won't run for a partly constructed vector
+    throw;
+  }
 }
 
 
 
 // Overloaded Assignment Operator
-template<typename T>
-ExtendableVector<T> & ExtendableVector<T>::operator=( const ExtendableVector<T> & rhs )
+template<typename T, GrowthPolicy Growth>
+ExtendableVector<T, Growth> & ExtendableVector<T, Growth>::operator=( const ExtendableVector<T, Growth> & rhs )
 {
   if( this != &rhs )
   {
-    // Can the stuff in the right hand side (rhs) fit into this vector? If not, expand this vector's capacity
-    reserve( rhs._size );
-
-    std::copy( rhs._array, rhs._array + rhs._size, _array );
+    // Can the stuff in the right hand side (rhs) fit into this vector? If not, expand this vector's capacity.  Clearing first means
+    // nothing is moved just to be overwritten
+    if( rhs._size > _capacity )
+    {
+      clear();
+      reserve( rhs._size );
+    }
+
+    // Assign over the live elements, copy construct into raw storage past them, and destroy any left over
+    auto overlap = std::min( _size, rhs._size );
+    std::copy( rhs._array, rhs._array + overlap, _array );
+    std::uninitialized_copy( rhs._array + overlap, rhs._array + rhs._size, _array + overlap );
+    std::destroy( _array + rhs._size, _array + std::max( _size, rhs._size ) );
     _size = rhs._size;
   }
 
@@ -231,7 +494,72 @@ ExtendableVector<T> & ExtendableVector<T>::operator=( const ExtendableVector<T>
 
 
 
+// Move Constructor
+template <typename T, GrowthPolicy Growth>
+ExtendableVector<T, Growth>::ExtendableVector( ExtendableVector<T, Growth> && other ) noexcept
+: _size    ( std::exchange( other._size,     0       ) ),
+  _capacity( std::exchange( other._capacity, 0       ) ),
+  _array   ( std::exchange( other._array,    nullptr ) )
+{}                                                                        // other keeps no storage at all, nothing is copied
+
+
+
+// Move Assignment Operator
+template<typename T, GrowthPolicy Growth>
+ExtendableVector<T, Growth> & ExtendableVector<T, Growth>::operator=( ExtendableVector<T, Growth> && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    clear();
+    deallocate( _array, _capacity );
+
+    _size     = std::exchange( rhs._size,     0       );
+    _capacity = std::exchange( rhs._capacity, 0       );
+    _array    = std::exchange( rhs._array,    nullptr );
+  }
+
+  return *this;
+}
+
+
+
 // Destructor
-template <typename T>
-ExtendableVector<T>::~ExtendableVector()
-{ delete[] _array; }
+template <typename T, GrowthPolicy Growth>
+ExtendableVector<T, Growth>::~ExtendableVector()
+{
+  clear();                                                                // only live elements are destroyed, the rest of the storage is raw
+  deallocate( _array, _capacity );
+}
+
+
+
+template <typename T, GrowthPolicy Growth>
+std::size_t ExtendableVector<T, Growth>::grownCapacity() const
+{
+  if      constexpr( Growth == GrowthPolicy::DOUBLE         ) return _capacity == 0 ? 1 : 2 * _capacity;
+  else if constexpr( Growth == GrowthPolicy::ONE_AND_A_HALF ) return _capacity + _capacity / 2 + 1;
+  else                                                        return _capacity + std::max<std::size_t>( GROWTH_CHUNK / sizeof( T ), 1 );
+}
+
+
+
+template <typename T, GrowthPolicy Growth>
+T * ExtendableVector<T, Growth>::allocate( std::size_t capacity )
+{
+  if constexpr( RELOCATE_BY_REALLOC )
+  {
+    auto array = static_cast<T *>( std::malloc( capacity * sizeof( T ) ) );
+    if( array == nullptr  &&  capacity != 0 ) throw std::bad_alloc();
+    return array;
+  }
+  else return std::allocator<T>().allocate( capacity );
+}
+
+
+
+template <typename T, GrowthPolicy Growth>
+void ExtendableVector<T, Growth>::deallocate( T * array, std::size_t capacity )
+{
+  if constexpr( RELOCATE_BY_REALLOC ) std::free( array );
+  else                                std::allocator<T>().deallocate( array, capacity );
+}
@@ -1,10 +1,28 @@
-#include <iomanip>    // quoted()
+#include <algorithm>  // equal(), sort()
+#include <chrono>
+#include <cmath>      // abs()
+#include <cstddef>    // size_t
+#include <cstdint>    // int32_t
+#include <filesystem>
+#include <fstream>
+#include <iomanip>    // quoted(), setw(), setprecision()
 #include <iostream>
+#include <iterator>   // begin(), end()
+#include <numeric>    // accumulate()
+#include <random>
 #include <string>
+#include <utility>    // move(), pair, as_const()
+#include <vector>
 
+#include "CopyOnWrite.hpp"
 #include "ExtendableVector.hpp"
 #include "FixedVector.hpp"
+#include "MappedVector.hpp"
+#include "ParallelAlgorithms.hpp"
+#include "SegmentedVector.hpp"
+#include "SmallVector.hpp"
 #include "Student.hpp"
+#include "VectorKernels.hpp"
 
 
 
@@ -49,6 +67,324 @@ namespace    // anonymous
 
     vector = aCopy;    // assignment;
     for( const auto & student : aCopy ) std::cout << student;
+
+
+    // Moves hand the array over, nothing is copied
+    auto handedOff = std::move( aCopy );                              // move construction
+    vector = std::move( handedOff );                                  // move assignment
+    if( aCopy.size() != 0  ||  handedOff.size() != 0 ) std::cerr << "Moved-from vectors are not empty\n";
+
+    vector.emplace_back( "Erin", 4 );                                 // constructed in place
+    vector.push_back( std::move( s ) );                               // moved in
+    vector.emplace( vector.begin(), vector[ 3 ] );                    // a copy of one of its own elements
+    if( vector.size() != 6  ||  vector[0] != vector[4]  ||  vector[5].name() != "Adam" ) std::cerr << "Moved and emplaced elements do not match expected\n";
+    for( const auto & student : vector ) std::cout << student;
+
+
+    // Batch mutations shift the elements after them once, however many elements are added or removed
+    Student transfers[] = { Student( "Fatima", 1 ), Student( "Gus", 2 ) };
+    vector.insert( vector.begin() + 1, std::begin( transfers ), std::end( transfers ) );
+    vector.append( std::begin( transfers ), std::end( transfers ) );
+    if( vector.size() != 10  ||  vector[1].name() != "Fatima"  ||  vector[9].name() != "Gus" ) std::cerr << "Range insertion does not match expected\n";
+
+    vector.erase( vector.begin() + 8, vector.end() );
+    auto seniors = vector.erase_if( []( const Student & student ) { return student.semesters() > 3; } );
+    if( vector.size() != 6  ||  seniors != 2 ) std::cerr << "Range removal does not match expected\n";
+    for( const auto & student : vector ) std::cout << student;
+  }
+
+
+
+  // Counts the objects alive, and deliberately has no default constructor.  Vectors construct elements only as they're added, so
+  // constructing, growing, erasing, and clearing must leave exactly the added elements alive
+  struct Tracked
+  {
+    static inline long alive = 0;
+
+    explicit Tracked( int             id       ) : id( id          ) { ++alive; }
+             Tracked( const Tracked & original ) : id( original.id ) { ++alive; }
+             Tracked & operator=( const Tracked & ) = default;
+            ~Tracked()                                               { --alive; }
+
+    int id;
+  };
+
+  template<typename Vector>
+  void testLifetimes( std::size_t capacity )
+  {
+    Vector vector( capacity );
+    if( Tracked::alive != 0 ) std::cerr << "Unused capacity holds constructed elements\n";
+
+    for( int id = 0;  id < 100;  ++id ) vector.push_back( Tracked( id ) );
+    vector.insert( 50, Tracked( -1 ) );
+    vector.erase ( vector.begin() );
+    if( Tracked::alive != 100  ||  vector[49].id != -1 ) std::cerr << "Live elements do not match elements added\n";
+
+    auto aCopy = vector;
+    vector.clear();
+    vector = aCopy;
+    if( Tracked::alive != 200 ) std::cerr << "Live elements do not match elements added\n";
+  }
+
+  // Copies share the elements, until one of them is changed
+  template<typename Vector>
+  void testCopyOnWrite( std::size_t capacity )
+  {
+    CopyOnWrite<Vector> vector( capacity );
+    for( int id = 0;  id < 100;  ++id ) vector.push_back( Tracked( id ) );
+
+    auto         aCopy    = vector;
+    const auto & readOnly = aCopy;
+    if( Tracked::alive != 100  ||  !vector.isShared()  ||  readOnly[42].id != 42 ) std::cerr << "Copy did not share the elements\n";
+
+    aCopy.set( 42, Tracked( -1 ) );
+    if( Tracked::alive != 200  ||  vector.isShared()  ||  vector[42].id != 42  ||  aCopy[42].id != -1 ) std::cerr << "Changing a copy did not copy the elements first\n";
+
+    // A writable reference taken before copying must not reach into the copy, so copies of a vector that has handed one out don't share
+    auto & element   = vector[7];
+    auto   laterCopy = vector;
+    aCopy            = vector;
+    element          = Tracked( -7 );
+    if( vector.isShared()  ||  std::as_const( laterCopy )[7].id != 7  ||  std::as_const( aCopy )[7].id != 7 ) std::cerr << "Writing through an earlier reference changed a copy\n";
+  }
+
+
+
+  // Linux keeps the process's peak resident memory in /proc/self/status (VmHWM), and writing 5 to /proc/self/clear_refs resets it to
+  // the current resident memory.  Elsewhere the peak reads as 0
+  void resetPeakMemory()
+  { std::ofstream( "/proc/self/clear_refs" ) << "5"; }
+
+  double peakMemoryMiB()
+  {
+    std::ifstream status( "/proc/self/status" );
+    for( std::string line;  std::getline( status, line ); )
+    {
+      if( line.rfind( "VmHWM:", 0 ) == 0 ) return std::stod( line.substr( 6 ) ) / 1024;   // reported in kB
+    }
+    return 0;
+  }
+
+  // An int that isn't trivially copyable, so vectors of it relocate element by element instead of with realloc()
+  struct BoxedInt
+  {
+    BoxedInt( int value ) : value( value ) {}
+    BoxedInt( const BoxedInt & original ) : value( original.value ) {}
+    BoxedInt & operator=( const BoxedInt & ) = default;
+
+    int value;
+  };
+
+  // Inserts batchSize ints at the front of a vector of size ints one at a time, then all at once.  Returns the milliseconds taken by each
+  std::pair<double, double> timeBatchInsert( unsigned size, unsigned batchSize )
+  {
+    std::vector<int> batch( batchSize, -1 );
+    ExtendableVector<int> oneAtATime, allAtOnce;
+    for( unsigned i = 0;  i < size;  ++i ) oneAtATime.push_back( static_cast<int>( i ) );
+    allAtOnce = oneAtATime;
+
+    auto start = std::chrono::steady_clock::now();
+    for( auto value : batch ) oneAtATime.insert( std::size_t( 0 ), value );
+    auto middle = std::chrono::steady_clock::now();
+    allAtOnce.insert( std::size_t( 0 ), batch.begin(), batch.end() );
+    auto stop  = std::chrono::steady_clock::now();
+
+    if( oneAtATime.size() != allAtOnce.size()  ||  !std::equal( oneAtATime.begin(), oneAtATime.end(), allAtOnce.begin() ) ) std::cerr << "Batch insertion does not match single insertions\n";
+    return { std::chrono::duration<double, std::milli>( middle - start ).count(), std::chrono::duration<double, std::milli>( stop - middle ).count() };
+  }
+
+  // Builds a million vectors of 4 ints each, all alive at once.  Returns the milliseconds taken
+  template<typename Vector>
+  double timeSmallVectors()
+  {
+    auto start = std::chrono::steady_clock::now();
+    {
+      std::vector<Vector> vectors( 1'000'000 );
+      for( auto & vector : vectors ) for( int i = 0;  i < 4;  ++i ) vector.push_back( i );
+    }
+    return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+  }
+
+  // Times every push_back of count students individually.  Returns the median, the 99.9th percentile, and the slowest, in nanoseconds
+  template<typename Vector>
+  std::vector<double> pushBackLatencies( unsigned count )
+  {
+    std::vector<double> latencies;
+    latencies.reserve( count );
+
+    Vector  students;
+    Student student( "Hana", 1 );
+    for( unsigned i = 0;  i < count;  ++i )
+    {
+      auto start = std::chrono::steady_clock::now();
+      students.push_back( student );
+      latencies.push_back( std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() );
+    }
+
+    std::sort( latencies.begin(), latencies.end() );
+    return { latencies[ count / 2 ], latencies[ count - count / 1000 ], latencies.back() };
+  }
+
+  // Runs each kernel over a million elements, limited to each instruction set in turn, and reports the gigabytes scanned per second.
+  // The scalar column is the standard algorithm over begin() and end()
+  template<typename T>
+  void benchmarkKernels( const char * type )
+  {
+    using VectorKernels::InstructionSet;
+    constexpr std::size_t count   = 1'000'000;
+    constexpr unsigned    repeats = 32;
+
+    ExtendableVector<T> values( count );
+    for( std::size_t i = 0;  i < count;  ++i ) values.push_back( static_cast<T>( i % 1000 ) );
+
+    const std::pair<const char *, double (*)( ExtendableVector<T> & )> kernels[] =
+    {
+      { "find",  []( ExtendableVector<T> & v ) { return static_cast<double>( VectorKernels::find ( v, T( -1 ) ) - v.begin() ); } },   // not there, so scans it all
+      { "count", []( ExtendableVector<T> & v ) { return static_cast<double>( VectorKernels::count( v, T( 7  ) ) ); } },
+      { "min",   []( ExtendableVector<T> & v ) { return static_cast<double>( VectorKernels::min  ( v ) ); } },
+      { "max",   []( ExtendableVector<T> & v ) { return static_cast<double>( VectorKernels::max  ( v ) ); } },
+      { "sum",   []( ExtendableVector<T> & v ) { return static_cast<double>( VectorKernels::sum  ( v ) ); } }
+    };
+
+    for( auto & [name, kernel] : kernels )
+    {
+      std::cout << "  " << std::setw( 7 ) << std::left << type << std::setw( 6 ) << name << std::right;
+
+      double expected = 0;
+      for( auto instructionSet : { InstructionSet::SCALAR, InstructionSet::SSE2, InstructionSet::AVX2 } )
+      {
+        VectorKernels::limitInstructionSet( instructionSet );
+        if( VectorKernels::instructionSet() != instructionSet ) break;     // the processor doesn't support it
+
+        double total = 0;
+        auto   start = std::chrono::steady_clock::now();
+        for( unsigned i = 0;  i < repeats;  ++i ) total += kernel( values );
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if( instructionSet == InstructionSet::SCALAR ) expected = total;
+        else if( std::abs( total - expected ) > 1e-3 * std::abs( expected ) ) std::cerr << "Vector kernel result does not match the scalar loop\n";
+
+        std::cout << std::setw( 9 ) << std::fixed << std::setprecision( 1 ) << repeats * count * sizeof( T ) / elapsed.count() / 1e9;
+      }
+      std::cout << '\n';
+    }
+
+    VectorKernels::limitInstructionSet( InstructionSet::AVX2 );
+  }
+
+  // Sorts, updates, and totals count students with 1, 2, 4, ... threads up to the number of cores, checking each result against the
+  // serial algorithm's.  Times are in milliseconds
+  void benchmarkParallel( unsigned count )
+  {
+    std::mt19937 random( 131 );
+    ExtendableVector<Student> students( count );
+    for( unsigned i = 0;  i < count;  ++i ) students.emplace_back( "Student " + std::to_string( random() % count ), random() % 8 + 1 );
+
+    auto sorted = students;
+    auto start  = std::chrono::steady_clock::now();
+    std::sort( sorted.begin(), sorted.end() );
+    std::cout << "\n" << count << " students, std::sort " << std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() << " ms\n"
+              << "  threads      sort  for_each  transform    reduce\n";
+
+    auto & taskPool = TaskPool::instance();
+    auto   cores    = taskPool.concurrency();
+    for( std::size_t threads = 1;  threads <= cores;  threads *= 2 )
+    {
+      taskPool.setConcurrency( threads );
+      auto copy = students;
+      std::vector<unsigned> semesters( count );
+
+      auto t0 = std::chrono::steady_clock::now();
+      Parallel::sort( copy.begin(), copy.end() );
+      auto t1 = std::chrono::steady_clock::now();
+      Parallel::for_each( copy.begin(), copy.end(), []( Student & student ) { student.updateNSemesters(); } );
+      auto t2 = std::chrono::steady_clock::now();
+      Parallel::transform( copy.begin(), copy.end(), semesters.begin(), []( Student & student ) { return student.semesters(); } );
+      auto t3 = std::chrono::steady_clock::now();
+      auto total = Parallel::reduce( semesters.begin(), semesters.end(), 0ULL );
+      auto t4 = std::chrono::steady_clock::now();
+
+      bool matches = std::equal( copy.begin(), copy.end(), sorted.begin(), []( const Student & lhs, const Student & rhs )
+                                 { return lhs.name() == rhs.name()  &&  lhs.semesters() == rhs.semesters() + 1; } );
+      if( !matches  ||  total != std::accumulate( semesters.begin(), semesters.end(), 0ULL ) ) std::cerr << "Parallel algorithm results do not match serial results\n";
+
+      using Milliseconds = std::chrono::duration<double, std::milli>;
+      std::cout << std::fixed << std::setprecision( 1 ) << std::setw( 9 ) << threads
+                << std::setw( 10 ) << Milliseconds( t1 - t0 ).count() << std::setw( 10 ) << Milliseconds( t2 - t1 ).count()
+                << std::setw( 11 ) << Milliseconds( t3 - t2 ).count() << std::setw( 10 ) << Milliseconds( t4 - t3 ).count() << '\n';
+    }
+    taskPool.setConcurrency( cores );
+  }
+
+  // Fills a file backed vector, then reopens it.  Reopening maps the file rather than reading it, so it takes the same time however
+  // many elements there are, and the elements are read straight from the page cache
+  void testMappedVector( unsigned count )
+  {
+    auto path = std::filesystem::temp_directory_path() / "Extendable_Fixed_Vector_main.mapped";
+    std::filesystem::remove( path );
+
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    auto start = std::chrono::steady_clock::now();
+    {
+      MappedVector<std::int32_t> numbers( path.string() );
+      for( unsigned i = 0;  i < count;  ++i ) numbers.push_back( static_cast<std::int32_t>( i % 1000 ) );
+    }
+    auto filled = std::chrono::steady_clock::now();
+
+    MappedVector<std::int32_t> reopened( path.string() );
+    auto opened = std::chrono::steady_clock::now();
+    auto total  = VectorKernels::sum( reopened );
+    auto summed = std::chrono::steady_clock::now();
+
+    if( reopened.size() != count  ||  reopened[ count - 1 ] != static_cast<std::int32_t>( ( count - 1 ) % 1000 )  ||  total != count / 1000 * 499'500LL ) std::cerr << "Reopened mapped vector does not match values pushed\n";
+    std::cout << "\nFile backed vector of " << count << " ints:  filled in " << Milliseconds( filled - start ).count() << " ms,  reopened in "
+              << Milliseconds( opened - filled ).count() << " ms,  summed in " << Milliseconds( summed - opened ).count() << " ms\n";
+
+    std::filesystem::remove( path );                                  // POSIX keeps the mapping until the vector is destroyed
+  }
+
+  // Both only read the students, but passing an ExtendableVector by value copies every one of them
+  std::size_t countSeniors( ExtendableVector<Student> students )
+  { return static_cast<std::size_t>( std::count_if( students.begin(), students.end(), []( const Student & student ) { return student.semesters() > 4; } ) ); }
+
+  std::size_t countSeniors( CopyOnWrite<ExtendableVector<Student>> students )
+  {
+    const auto & readOnly = students;                                 // the non-const begin() and end() would copy the shared students
+    return static_cast<std::size_t>( std::count_if( readOnly.begin(), readOnly.end(), []( const Student & student ) { return student.semesters() > 4; } ) );
+  }
+
+  void benchmarkCopyOnWrite( unsigned count, unsigned calls )
+  {
+    ExtendableVector<Student> students( count );
+    for( unsigned i = 0;  i < count;  ++i ) students.emplace_back( "Student " + std::to_string( i ), i % 8 + 1 );
+    CopyOnWrite<ExtendableVector<Student>> shared( students );
+
+    std::size_t copiedSeniors = 0,  sharedSeniors = 0;
+    auto start = std::chrono::steady_clock::now();
+    for( unsigned i = 0;  i < calls;  ++i ) copiedSeniors += countSeniors( students );
+    auto middle = std::chrono::steady_clock::now();
+    for( unsigned i = 0;  i < calls;  ++i ) sharedSeniors += countSeniors( shared );
+    auto stop = std::chrono::steady_clock::now();
+
+    if( copiedSeniors != sharedSeniors  ||  shared.isShared() ) std::cerr << "Copy-on-write vector results do not match\n";
+    std::cout << "\nPassing " << count << " students by value " << calls << " times:  ExtendableVector " << std::chrono::duration<double, std::milli>( middle - start ).count()
+              << " ms,  CopyOnWrite " << std::chrono::duration<double, std::milli>( stop - middle ).count() << " ms\n";
+  }
+
+  template<typename Vector>
+  void benchmarkGrowth( const char * policy, unsigned count )
+  {
+    resetPeakMemory();
+    auto start = std::chrono::steady_clock::now();
+    {
+      Vector numbers;
+      for( unsigned i = 0;  i < count;  ++i ) numbers.push_back( static_cast<int>( i ) );
+      if( numbers.size() != count ) std::cerr << "Vector size does not match values pushed\n";
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::setw( 22 ) << std::left << policy << std::right << std::setw( 8 ) << std::fixed << std::setprecision( 0 ) << elapsed.count() << " ms,  "
+              << "peak resident " << std::setw( 5 ) << peakMemoryMiB() << " MiB\n";
   }
 }    // anonymous namespace
 
@@ -58,9 +394,68 @@ int main()
 {
   FixedVector<Student>      fixedStudentVector( 10 );
   ExtendableVector<Student> extendableStudentVector;                  // in contrast to FixedVector, capacity is not specified
+  SmallVector<Student, 4>   smallStudentVector;                       // the first 4 students are kept inside the vector itself
+  SegmentedVector<Student>  segmentedStudentVector;                   // students are kept in chunks of 1024 that never move
+  CopyOnWrite<ExtendableVector<Student>> sharedStudentVector;         // copies share the students until one is changed
 
   test( fixedStudentVector      );
   test( extendableStudentVector );
+  test( smallStudentVector      );
+  test( segmentedStudentVector  );
+  test( sharedStudentVector     );
+
+  testLifetimes<FixedVector     <Tracked>>( 1024 );
+  testLifetimes<ExtendableVector<Tracked>>( 8    );
+  testLifetimes<SmallVector     <Tracked>>( 8    );
+  testLifetimes<SegmentedVector <Tracked, 16>>( 8 );
+  testCopyOnWrite<ExtendableVector<Tracked>>( 8    );
+  testCopyOnWrite<FixedVector     <Tracked>>( 1024 );
+  if( Tracked::alive != 0 ) std::cerr << "Destroyed vectors left elements alive\n";
+
+
+  // Small vectors that never outgrow their inline capacity cost no allocations at all
+  std::cout << "\n\nA million 4 int vectors:  ExtendableVector " << timeSmallVectors<ExtendableVector<int>>() << " ms,  "
+            << "SmallVector " << timeSmallVectors<SmallVector<int>>() << " ms,  "
+            << sizeof( SmallVector<int> ) << " bytes each rather than " << sizeof( ExtendableVector<int> ) << " + " << 64 * sizeof( int ) << " on the heap\n";
+
+
+  auto [oneAtATime, allAtOnce] = timeBatchInsert( 100'000, 10'000 );
+  std::cout << "Inserting 10,000 ints at the front of 100,000:  one at a time " << oneAtATime << " ms,  as one range " << allAtOnce << " ms\n";
+
+
+  // ExtendableVector's occasional relocation of every element shows up in its slowest push_backs, not its typical one.  Growing a
+  // SegmentedVector only ever allocates one chunk
+  constexpr unsigned pushes = 4'000'000;
+  auto extendable = pushBackLatencies<ExtendableVector<Student>>( pushes );
+  auto segmented  = pushBackLatencies<SegmentedVector <Student>>( pushes );
+  std::cout << "\nPushing " << pushes << " students (ns)      median   p99.9       max\n" << std::fixed << std::setprecision( 0 )
+            << "  ExtendableVector           " << std::setw( 6 ) << extendable[0] << std::setw( 8 ) << extendable[1] << std::setw( 10 ) << extendable[2] << '\n'
+            << "  SegmentedVector            " << std::setw( 6 ) << segmented [0] << std::setw( 8 ) << segmented [1] << std::setw( 10 ) << segmented [2] << '\n';
+
+
+  // Scans of int32_t, float, and double vectors compare 32 bytes of elements at a time with AVX2, where the processor has it
+  std::cout << "\nKernels (GB/s)    scalar     SSE2     AVX2\n";
+  benchmarkKernels<std::int32_t>( "int32"  );
+  benchmarkKernels<float       >( "float"  );
+  benchmarkKernels<double      >( "double" );
+
+
+  testMappedVector( 50'000'000 );
+  benchmarkCopyOnWrite( 1'000'000, 20 );
+
+
+  // The parallel algorithms split the vector's contiguous elements across the shared TaskPool
+  benchmarkParallel( 2'000'000 );
+
+
+  // Growth policies trade peak memory against the number of reallocations.  Ints are relocated with realloc(), which extends (or
+  // remaps) large blocks without copying them, while the boxed ints are moved one by one into each new array
+  constexpr unsigned N = 100'000'000;
+  std::cout << "\n\nPushing " << N << " ints\n";
+  benchmarkGrowth<ExtendableVector<int,      GrowthPolicy::DOUBLE        >>( "2x",                  N );
+  benchmarkGrowth<ExtendableVector<int,      GrowthPolicy::ONE_AND_A_HALF>>( "1.5x",                N );
+  benchmarkGrowth<ExtendableVector<int,      GrowthPolicy::FIXED_CHUNK   >>( "1 MiB chunks",        N );
+  benchmarkGrowth<ExtendableVector<BoxedInt, GrowthPolicy::DOUBLE        >>( "2x, without realloc", N );
 
   return 0;
 }
@@ -1,8 +1,13 @@
 #pragma once
 
-#include <algorithm>                                                      // move(), move_backward(), copy()
+#include <algorithm>                                                      // move(), move_backward(), copy(), min(), max(), rotate(), remove_if()
 #include <cstddef>                                                        // size_t
+#include <iterator>                                                       // iterator_traits, distance()
+#include <memory>                                                         // allocator, uninitialized_copy_n(), uninitialized_copy(), destroy()
+#include <new>                                                            // placement new
 #include <stdexcept>                                                      // range_error
+#include <type_traits>                                                    // is_base_of
+#include <utility>                                                        // forward(), exchange()
 
 
 
@@ -15,7 +20,9 @@ class FixedVector
     // Constructors, destructor, and assignments
     FixedVector            ( std::size_t capacity = 64 );                 // power of 2, but nothing special about 2^6
     FixedVector            ( const FixedVector & other );                 // Copy constructor
+    FixedVector            (       FixedVector && other ) noexcept;       // Move constructor, takes over other's array leaving other empty
     FixedVector & operator=( const FixedVector & rhs   );                 // Copy assignment
+    FixedVector & operator=(       FixedVector && rhs  ) noexcept;        // Move assignment
    ~FixedVector            ();
 
     // Queries
@@ -33,22 +40,49 @@ class FixedVector
 
     // Mutators
     void        push_back( const T & value );                             // Checks capacity, throws std::range_error
+    void        push_back(       T && value );                            // Checks capacity, throws std::range_error
+    template <typename... Args>
+    T &         emplace_back( Args &&... args );                          // Constructs the new element in place from args.  Checks capacity, throws std::range_error
 
     std::size_t erase( std::size_t index    );                            // Checks bounds, throws std::range_error
     T *         erase( T *         position );                            // Checks bounds, throws std::range_error
+    std::size_t erase( std::size_t first, std::size_t last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+    T *         erase( T *         first, T *         last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+
+    template <typename Predicate>
+    std::size_t erase_if( Predicate predicate );                          // Removes every element predicate( element ) is true for in a single pass.  Returns the number removed
 
     void        set( std::size_t index, const T & value );                // Checks bounds, throws std::range_error
+    void        set( std::size_t index,      T && value );                // Checks bounds, throws std::range_error
 
     std::size_t insert( std::size_t beforeIndex,    const T & value );    // Checks capacity, throws std::range_error
     T *         insert( T *         beforePosition, const T & value );    // Checks capacity, throws std::range_error
+    std::size_t insert( std::size_t beforeIndex,         T && value );    // Checks capacity, throws std::range_error
+    T *         insert( T *         beforePosition,      T && value );    // Checks capacity, throws std::range_error
+
+    template <typename... Args>
+    std::size_t emplace( std::size_t beforeIndex,    Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+    template <typename... Args>
+    T *         emplace( T *         beforePosition, Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+
+    // Inserts copies of [first, last), which must not refer to this vector's elements, shifting the elements after them only once
+    template <typename InputIterator>
+    std::size_t insert( std::size_t beforeIndex,    InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    T *         insert( T *         beforePosition, InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    void        append( InputIterator first, InputIterator last );       // Checks capacity, throws std::range_error
 
     void clear();
 
 
   private:
-    std::size_t       _size     = 0;                                      // number of elements in the data structure
-    std::size_t const _capacity = 0;                                      // length of the array
-    T *               _array    = nullptr;                                // pointer to dynamically allocated array
+    std::size_t _size     = 0;                                            // number of elements in the data structure
+    std::size_t _capacity = 0;                                            // length of the array, fixed except when taken over by a move
+    T *         _array    = nullptr;                                      // pointer to dynamically allocated array
+
+    static T *  allocate  ( std::size_t capacity );                       // raw, uninitialized storage for capacity elements
+    static void deallocate( T * array, std::size_t capacity );
 };
 
 
@@ -61,8 +95,8 @@ class FixedVector
 // Constructor with initial capacity argument
 template<typename T>
 FixedVector<T>::FixedVector( std::size_t capacity )
-  : _size( 0 ), _capacity( capacity ), _array( new T[capacity]() )
-{}
+  : _size( 0 ), _capacity( capacity ), _array( allocate( capacity ) )
+{}                                                                        // storage only, no elements are constructed until added
 
 
 
@@ -115,6 +149,19 @@ void FixedVector<T>::push_back( const T & value )
 
 
 
+template <typename T>
+void FixedVector<T>::push_back( T && value )
+{ insert( _size, std::move( value ) ); }                                  // delegate to insert() leveraging error checking
+
+
+
+template <typename T>
+template <typename... Args>
+T & FixedVector<T>::emplace_back( Args &&... args )
+{ return _array[ emplace( _size, std::forward<Args>( args )... ) ]; }     // delegate to emplace() leveraging error checking
+
+
+
 // Overloaded Array-Access Operator
 template <typename T>
 T & FixedVector<T>::operator[]( std::size_t index )
@@ -128,6 +175,12 @@ void FixedVector<T>::set( std::size_t index, const T & value )
 
 
 
+template <typename T>
+void FixedVector<T>::set( std::size_t index, T && value )
+{ at( index ) = std::move( value ); }                                     // delegate to at() leveraging error checking
+
+
+
 // Removes element from position. Elements from higher positions are shifted back to fill gap.
 // Vector size decrements
 template <typename T>
@@ -137,7 +190,7 @@ std::size_t FixedVector<T>::erase( std::size_t index )
 
   // shift elements to the left and decrement the number of elements in the container
   std::move( _array + index + 1, _array + _size, _array + index );        // Note the pointer arithmetic here
-  --_size;
+  _array[--_size].~T();                                                   // the last slot now holds a moved-from element
 
   return index;
 }
@@ -155,17 +208,84 @@ T * FixedVector<T>::erase( T * position )
 
 
 
+template <typename T>
+std::size_t FixedVector<T>::erase( std::size_t first, std::size_t last )
+{
+  if( first > last  ||  last > _size ) throw std::range_error( "index out of bounds" );
+
+  // shift the elements after the range left once, then destroy the moved-from elements left at the end
+  std::move( _array + last, _array + _size, _array + first );             // Note the pointer arithmetic here
+  std::destroy( _array + _size - ( last - first ), _array + _size );
+  _size -= last - first;
+
+  return first;
+}
+
+
+
+template <typename T>
+T * FixedVector<T>::erase( T * first, T * last )
+{
+  // delegate to delete by index
+  erase( first - begin(), last - begin() );                               // Note the pointer arithmetic here
+  return first;
+}
+
+
+
+// Keeps the elements predicate is false for in their original order, each moved at most once
+template <typename T>
+template <typename Predicate>
+std::size_t FixedVector<T>::erase_if( Predicate predicate )
+{
+  auto kept    = std::remove_if( begin(), end(), predicate );
+  auto removed = static_cast<std::size_t>( end() - kept );
+
+  std::destroy( kept, end() );
+  _size -= removed;
+
+  return removed;
+}
+
+
+
 // Copies x to element at position. Items at that position and higher are shifted over to make room. Vector size increments.
 template <typename T>
 std::size_t FixedVector<T>::insert( std::size_t beforeIndex, const T & value )
+{ return emplace( beforeIndex, value ); }
+
+
+
+template <typename T>
+std::size_t FixedVector<T>::insert( std::size_t beforeIndex, T && value )
+{ return emplace( beforeIndex, std::move( value ) ); }
+
+
+
+// Constructs a new element from args at position.  Items at that position and higher are shifted over to make room.  Vector size
+// increments.
+template <typename T>
+template <typename... Args>
+std::size_t FixedVector<T>::emplace( std::size_t beforeIndex, Args &&... args )
 {
   if( _size       >= _capacity ) throw std::range_error( "insufficient capacity to add another element" );
   if( beforeIndex >  _size     ) beforeIndex = _size;                     // insert at the back
 
-  // move elements to create space starting from the right and working left
-  std::move_backward( _array + beforeIndex, _array + _size, _array + _size + 1 );    // Note the pointer arithmetic here
+  if( beforeIndex == _size )
+  {
+    new( _array + _size ) T( std::forward<Args>( args )... );             // construct directly in the raw slot past the end
+    return _size++;
+  }
+
+  // args may refer to an element of this vector, so the new element is made before anything moves
+  T element( std::forward<Args>( args )... );
 
-  _array[ beforeIndex ] = value;                                          // make a copy of the element in the empty slot
+  // The raw slot past the end is constructed from the last element, then the remaining elements move to create space starting from
+  // the right and working left
+  new( _array + _size ) T( std::move( _array[ _size - 1 ] ) );
+  std::move_backward( _array + beforeIndex, _array + _size - 1, _array + _size );   // Note the pointer arithmetic here
+
+  _array[ beforeIndex ] = std::move( element );                           // move the new element into the vacated slot
   ++_size;
 
   return beforeIndex;
@@ -178,7 +298,89 @@ T* FixedVector<T>::insert( T * beforePosition, const T & value )
 {
   auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
   insert( index, value );
-  return beforePosition;
+  return begin() + index;
+}
+
+
+
+template <typename T>
+T* FixedVector<T>::insert( T * beforePosition, T && value )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, std::move( value ) );
+  return begin() + index;
+}
+
+
+
+template <typename T>
+template <typename... Args>
+T* FixedVector<T>::emplace( T * beforePosition, Args &&... args )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  emplace( index, std::forward<Args>( args )... );
+  return begin() + index;
+}
+
+
+
+// The new elements are appended in one pass, then a single rotation moves them into place shifting the elements after them
+template <typename T>
+template <typename InputIterator>
+std::size_t FixedVector<T>::insert( std::size_t beforeIndex, InputIterator first, InputIterator last )
+{
+  if( beforeIndex > _size ) beforeIndex = _size;                          // insert at the back
+
+  auto oldSize = _size;
+  append( first, last );
+  std::rotate( _array + beforeIndex, _array + oldSize, _array + _size );  // Note the pointer arithmetic here
+
+  return beforeIndex;
+}
+
+
+
+template <typename T>
+template <typename InputIterator>
+T* FixedVector<T>::insert( T * beforePosition, InputIterator first, InputIterator last )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, first, last );
+  return begin() + index;
+}
+
+
+
+// When the range can be measured up front, room for all of it is made at once.  Otherwise elements are added one at a time.  Either
+// way, if adding an element fails the elements already added are removed again
+template <typename T>
+template <typename InputIterator>
+void FixedVector<T>::append( InputIterator first, InputIterator last )
+{
+  using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  if constexpr( std::is_base_of_v<std::forward_iterator_tag, Category> )
+  {
+    auto count = static_cast<std::size_t>( std::distance( first, last ) );
+    if( _size + count > _capacity ) throw std::range_error( "insufficient capacity to add the elements" );
+
+    std::uninitialized_copy( first, last, _array + _size );              // destroys the copies already made if one throws
+    _size += count;
+  }
+  else
+  {
+    auto oldSize = _size;
+    try
+    {
+      for( ;  first != last;  ++first ) emplace_back( *first );
+    }
+    catch( ... )
+    {
+      std::destroy( _array + oldSize, _array + _size );
+      _size = oldSize;
+      throw;
+    }
+  }
 }
 
 
@@ -186,10 +388,19 @@ T* FixedVector<T>::insert( T * beforePosition, const T & value )
 // Copy Constructor
 template <typename T>
 FixedVector<T>::FixedVector( const FixedVector<T> & other )
-: _size( other._size ), _capacity( other._capacity ), _array( new T[other._capacity]() )
+: _size( 0 ), _capacity( other._capacity ), _array( allocate( other._capacity ) )
 {
-  // Copy each element from the other vector to this vector
-  std::copy_n( other._array, other._size, _array );
+  // Copy construct each element from the other vector into this vector's raw storage
+  try
+  {
+    std::uninitialized_copy_n( other._array, other._size, _array );
+    _size = other._size;
+  }
+  catch( ... )
+  {
+    deallocate( _array, _capacity );                                      // the destructor won't run for a partly constructed vector
+    throw;
+  }
 }
 
 
@@ -200,10 +411,45 @@ FixedVector<T> & FixedVector<T>::operator=( const FixedVector<T> & rhs )
 {
   if( this != &rhs )
   {
-    // Being fixed size, the already allocated array can be reused. Capacity is not adjusted.  If _capacity < rhs._capacity, then some
-    // rhs elements may not be copied and the vector is truncated.
-    std::copy( rhs._array, rhs._array + rhs._size, _array );
-    _size = rhs._size;
+    // Being fixed size, the already allocated array can be reused. Capacity is not adjusted.  If _capacity < rhs._size, then some
+    // rhs elements are not copied and the vector is truncated.
+    auto newSize = std::min( rhs._size, _capacity );
+
+    // Assign over the live elements, copy construct into raw storage past them, and destroy any left over
+    auto overlap = std::min( _size, newSize );
+    std::copy( rhs._array, rhs._array + overlap, _array );
+    std::uninitialized_copy( rhs._array + overlap, rhs._array + newSize, _array + overlap );
+    std::destroy( _array + newSize, _array + std::max( _size, newSize ) );
+    _size = newSize;
+  }
+
+  return *this;
+}
+
+
+
+// Move Constructor
+template <typename T>
+FixedVector<T>::FixedVector( FixedVector<T> && other ) noexcept
+: _size    ( std::exchange( other._size,     0       ) ),
+  _capacity( std::exchange( other._capacity, 0       ) ),
+  _array   ( std::exchange( other._array,    nullptr ) )
+{}                                                                        // other keeps no storage at all, nothing is copied
+
+
+
+// Move Assignment Operator
+template<typename T>
+FixedVector<T> & FixedVector<T>::operator=( FixedVector<T> && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    clear();
+    deallocate( _array, _capacity );
+
+    _size     = std::exchange( rhs._size,     0       );
+    _capacity = std::exchange( rhs._capacity, 0       );
+    _array    = std::exchange( rhs._array,    nullptr );
   }
 
   return *this;
@@ -214,4 +460,19 @@ FixedVector<T> & FixedVector<T>::operator=( const FixedVector<T> & rhs )
 // Destructor
 template <typename T>
 FixedVector<T>::~FixedVector()
-{ delete[] _array; }
+{
+  clear();                                                                // only live elements are destroyed, the rest of the storage is raw
+  deallocate( _array, _capacity );
+}
+
+
+
+template <typename T>
+T * FixedVector<T>::allocate( std::size_t capacity )
+{ return std::allocator<T>().allocate( capacity ); }
+
+
+
+template <typename T>
+void FixedVector<T>::deallocate( T * array, std::size_t capacity )
+{ std::allocator<T>().deallocate( array, capacity ); }
@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>  // min()
+#include <cstddef>    // size_t
+#include <stdexcept>  // invalid_argument
+#include <utility>    // pair, move()
+#include <vector>
+
+/*******************************************************************************
+**  Frozen (immutable) Binary Search Tree
+**
+**  A read-only snapshot of a BinarySearchTree laid out in Eytzinger (breadth first) order in one contiguous array:  the root is at
+**  index 1 and the children of the node at index k are at indexes 2k and 2k+1.  No pointers are stored, the top levels of the tree
+**  share the first few cache lines, and because a node's descendants a few levels down are adjacent in memory they can be prefetched
+**  while the current level is compared.  Keys are kept apart from values so each cache line holds as many keys as possible.
+**
+**  search() has the same semantics as BinarySearchTree::search(), including returning the first inserted of duplicate keys.
+*******************************************************************************/
+template <typename Key, typename Value>
+class FrozenBinarySearchTree {
+  public:
+    FrozenBinarySearchTree() = default;
+    FrozenBinarySearchTree( std::vector<std::pair<Key, Value>> sortedEntries );   // entries must be in ascending (inorder) key order
+
+    // Queries
+    Value       search( const Key & key ) const;                            // Returns the value associated with the first inserted matching key. Throws invalid_argument if key not found
+    std::size_t size  ()                  const;                            // Returns the number of entries in the tree
+
+
+  private:
+    std::vector<Key>   keys_;                                               // keys_[k] is the key of Eytzinger node k, keys_[0] is unused
+    std::vector<Value> values_;                                             // values_[k-1] is the value of Eytzinger node k
+
+    std::size_t lowerBound( const Key & key ) const;                        // Eytzinger index of the first key not less than key, or 0 if none
+
+    std::size_t layout( std::vector<std::pair<Key, Value>> & sortedEntries, // Moves sorted entries into Eytzinger order with an inorder walk
+                        std::size_t                          next,          // of the implicit tree rooted at index k.  Returns the index of
+                        std::size_t                          k );           // the next sorted entry to place
+  };
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  FrozenBinarySearchTree<Key, Value>  Definitions
+*******************************************************************************/
+template <typename Key, typename Value>
+FrozenBinarySearchTree<Key, Value>::FrozenBinarySearchTree( std::vector<std::pair<Key, Value>> sortedEntries )
+{
+  if( sortedEntries.empty() ) return;
+
+  keys_  .resize( sortedEntries.size() + 1, sortedEntries.front().first  );   // placeholders, every slot is overwritten by layout()
+  values_.resize( sortedEntries.size(),     sortedEntries.front().second );
+
+  layout( sortedEntries, 0, 1 );
+}
+
+
+
+
+template <typename Key, typename Value>
+std::size_t FrozenBinarySearchTree<Key, Value>::layout( std::vector<std::pair<Key, Value>> & sortedEntries, std::size_t next, std::size_t k )
+{
+  if( k > values_.size() ) return next;
+
+  next = layout( sortedEntries, next, 2 * k );                    // left subtree holds the smaller keys
+
+  keys_  [ k     ] = std::move( sortedEntries[ next ].first  );
+  values_[ k - 1 ] = std::move( sortedEntries[ next ].second );
+
+  return layout( sortedEntries, next + 1, 2 * k + 1 );            // right subtree holds the larger keys
+}
+
+
+
+
+template <typename Key, typename Value>
+std::size_t FrozenBinarySearchTree<Key, Value>::size() const
+{ return values_.size(); }
+
+
+
+
+//  Branch free descent:  every level is visited, going right while the key is smaller.  The index bits record the path taken, and the
+//  last left turn is where the lower bound was.  Duplicates are contiguous in inorder sequence, so the lower bound is the first inserted.
+template <typename Key, typename Value>
+std::size_t FrozenBinarySearchTree<Key, Value>::lowerBound( const Key & key ) const
+{
+  constexpr std::size_t KEYS_PER_CACHE_LINE = 64 / sizeof( Key ) > 0 ? 64 / sizeof( Key ) : 1;
+
+  const auto  n = values_.size();
+  std::size_t k = 1;
+
+  while( k <= n )
+  {
+    #if defined(__GNUC__)
+      __builtin_prefetch( keys_.data() + std::min( KEYS_PER_CACHE_LINE * k, n ) );   // descendants log2(KEYS_PER_CACHE_LINE) levels down share one cache line
+    #endif
+
+    k = 2 * k + ( keys_[ k ] < key );
+  }
+
+  while( k & 1 ) k >>= 1;                                         // undo the right turns taken after the last left turn
+  return k >> 1;                                                  // and the left turn itself
+}
+
+
+
+
+template <typename Key, typename Value>
+Value FrozenBinarySearchTree<Key, Value>::search( const Key & key ) const
+{
+  auto k = lowerBound( key );
+
+  if( k == 0  ||  !( keys_[ k ] == key ) ) throw std::invalid_argument( "Key not found" );
+  return values_[ k - 1 ];
+}
@@ -0,0 +1,519 @@
+#pragma once
+
+#include <algorithm>                                                      // copy(), copy_backward(), max(), rotate(), remove_if()
+#include <cerrno>                                                         // errno
+#include <cstddef>                                                        // size_t
+#include <cstdint>                                                        // uint32_t, uint64_t
+#include <cstring>                                                        // memcmp(), memcpy()
+#include <iterator>                                                       // iterator_traits, distance()
+#include <stdexcept>                                                      // range_error, runtime_error
+#include <string>
+#include <system_error>                                                   // system_error, generic_category()
+#include <type_traits>                                                    // is_trivially_copyable, is_base_of
+#include <utility>                                                        // move(), forward(), exchange()
+
+#include <fcntl.h>                                                        // open()
+#include <sys/mman.h>                                                     // mmap(), mremap(), munmap(), msync()
+#include <sys/stat.h>                                                     // fstat()
+#include <unistd.h>                                                       // ftruncate(), close()
+
+
+
+
+// Template Class Definition
+//   Same interface as ExtendableVector, but the elements live in a file mapped into memory (POSIX only).  The operating system's page
+//   cache pages them in and out, so the vector may be larger than RAM, and everything added is still there when the file is opened
+//   again - there's nothing to load or save.  The file starts with a small header holding the size and capacity, followed by
+//   capacity elements.  Growth extends the file and remaps it, so like ExtendableVector growth invalidates pointers to elements.
+//
+//   The elements are stored as raw bytes, so T must be trivially copyable and the file is only meant to be read back on the same
+//   platform by the same build.  Changes reach the file when the operating system writes back the pages; flush() waits for that.
+//   Mapped vectors own their file, so they can be moved but not copied.
+template<typename T>
+class MappedVector
+{
+  static_assert( std::is_trivially_copyable_v<T>, "Elements are stored in the file as raw bytes" );
+
+  public:
+    // Constructors, destructor, and assignments
+    MappedVector            ( const std::string & path, std::size_t capacity = 64 );   // Opens path, creating it if needed.  Throws std::runtime_error
+    MappedVector            ( const MappedVector & other ) = delete;
+    MappedVector            (       MappedVector && other ) noexcept;     // Move constructor, takes over other's file leaving other closed
+    MappedVector & operator=( const MappedVector & rhs   ) = delete;
+    MappedVector & operator=(       MappedVector && rhs  ) noexcept;      // Move assignment
+   ~MappedVector            ();
+
+    // Queries
+    T &          at        ( std::size_t index );                         // Checks bounds, throws std::range_error
+    T &          operator[]( std::size_t index );                         // No bounds checking
+
+    std::size_t size();
+    bool        empty();
+
+
+    // Iterators
+    T * begin();
+    T * end();
+
+
+    // Mutators
+    void push_back( const T & value );                                    // Grows the file, throws std::runtime_error if it can't
+    void push_back(       T && value );                                   // Grows the file, throws std::runtime_error if it can't
+    template <typename... Args>
+    T &  emplace_back( Args &&... args );                                 // Constructs the new element from args.  Grows the file, throws std::runtime_error if it can't
+
+    std::size_t erase( std::size_t index    );                            // Checks bounds, throws std::range_error
+    T *         erase( T *         position );                            // Checks bounds, throws std::range_error
+    std::size_t erase( std::size_t first, std::size_t last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+    T *         erase( T *         first, T *         last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+
+    template <typename Predicate>
+    std::size_t erase_if( Predicate predicate );                          // Removes every element predicate( element ) is true for in a single pass.  Returns the number removed
+
+    void set( std::size_t index, const T & value );                       // Checks bounds, throws std::range_error
+    void set( std::size_t index,      T && value );                       // Checks bounds, throws std::range_error
+
+    std::size_t insert( std::size_t beforeIndex,    const T & value );    // Grows the file, throws std::runtime_error if it can't
+    T *         insert( T *         beforePosition, const T & value );    // Grows the file, throws std::runtime_error if it can't
+    std::size_t insert( std::size_t beforeIndex,         T && value );    // Grows the file, throws std::runtime_error if it can't
+    T *         insert( T *         beforePosition,      T && value );    // Grows the file, throws std::runtime_error if it can't
+
+    template <typename... Args>
+    std::size_t emplace( std::size_t beforeIndex,    Args &&... args );  // Constructs the new element from args.  Grows the file, throws std::runtime_error if it can't
+    template <typename... Args>
+    T *         emplace( T *         beforePosition, Args &&... args );  // Constructs the new element from args.  Grows the file, throws std::runtime_error if it can't
+
+    // Inserts copies of [first, last), which must not refer to this vector's elements, shifting the elements after them only once
+    template <typename InputIterator>
+    std::size_t insert( std::size_t beforeIndex,    InputIterator first, InputIterator last );  // Grows the file, throws std::runtime_error if it can't
+    template <typename InputIterator>
+    T *         insert( T *         beforePosition, InputIterator first, InputIterator last );  // Grows the file, throws std::runtime_error if it can't
+    template <typename InputIterator>
+    void        append( InputIterator first, InputIterator last );       // Grows the file, throws std::runtime_error if it can't
+
+    void clear();
+    void flush();                                                         // Waits until every change has been written to the file.  Throws std::runtime_error
+
+
+  private:
+    // The first HEADER_BYTES of the file.  The size is kept here rather than in the vector, so it's saved along with the elements
+    struct Header
+    {
+      char          magic[8];                                             // identifies the file as a mapped vector
+      std::uint32_t elementSize;                                          // sizeof( T ) of the vector that wrote the file
+      std::uint32_t reserved;
+      std::uint64_t size;                                                 // number of elements in the data structure
+      std::uint64_t capacity;                                             // number of elements the file has room for
+    };
+
+    static constexpr char        MAGIC[8]     = { 'X', 'V', 'E', 'C', 'M', 'A', 'P', '1' };
+    static constexpr std::size_t HEADER_BYTES = 64;                       // elements start 64 byte aligned, as mappings start on a page
+    static_assert( sizeof( Header ) <= HEADER_BYTES  &&  alignof( T ) <= HEADER_BYTES, "Elements must fit after the header, suitably aligned" );
+
+    int         _file        = -1;                                        // file descriptor of the open file
+    Header *    _header      = nullptr;                                   // start of the mapping
+    T *         _array       = nullptr;                                   // first element, just past the header
+    std::size_t _mappedBytes = 0;                                         // length of the mapping
+
+    void        reserve ( std::size_t newCapacity );                      // helper function to extend the file and remap it
+    void        release ();                                               // unmaps and closes the file
+    static std::size_t fileBytes( std::size_t capacity );
+    [[noreturn]] static void fail( const char * operation );              // throws std::system_error describing errno
+};
+
+
+
+
+
+
+// Implementation
+
+// Opens an existing vector file, or creates a new one with room for capacity elements
+template<typename T>
+MappedVector<T>::MappedVector( const std::string & path, std::size_t capacity )
+{
+  _file = ::open( path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+  if( _file < 0 ) fail( "open" );
+
+  try
+  {
+    struct stat status;
+    if( ::fstat( _file, &status ) != 0 ) fail( "fstat" );
+    auto bytes = static_cast<std::size_t>( status.st_size );
+
+    if( bytes == 0 )                                                      // a new file
+    {
+      capacity = std::max<std::size_t>( capacity, 1 );
+      bytes    = fileBytes( capacity );
+      if( ::ftruncate( _file, static_cast<off_t>( bytes ) ) != 0 ) fail( "ftruncate" );
+    }
+    else if( bytes < HEADER_BYTES ) throw std::runtime_error( path + " is not a mapped vector file" );
+
+    void * mapping = ::mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0 );
+    if( mapping == MAP_FAILED ) fail( "mmap" );
+    _header      = static_cast<Header *>( mapping );
+    _array       = reinterpret_cast<T *>( static_cast<char *>( mapping ) + HEADER_BYTES );
+    _mappedBytes = bytes;
+
+    if( status.st_size == 0 )
+    {
+      std::memcpy( _header->magic, MAGIC, sizeof( MAGIC ) );
+      _header->elementSize = sizeof( T );
+      _header->reserved    = 0;
+      _header->size        = 0;
+      _header->capacity    = capacity;
+    }
+    else
+    {
+      // Reopening restores the vector just as it was left, after checking the file really holds one of this element type
+      if( std::memcmp( _header->magic, MAGIC, sizeof( MAGIC ) ) != 0  ||  _header->elementSize != sizeof( T )
+      ||  fileBytes( _header->capacity ) > bytes                      ||  _header->size > _header->capacity )
+      {
+        throw std::runtime_error( path + " is not a mapped vector file of this element type" );
+      }
+      if( capacity > _header->capacity ) reserve( capacity );
+    }
+  }
+  catch( ... )
+  {
+    release();
+    throw;
+  }
+}
+
+
+
+template <typename T>
+std::size_t MappedVector<T>::size()
+{ return _header == nullptr ? 0 : _header->size; }                        // moved-from vectors have no file
+
+
+
+template <typename T>
+bool MappedVector<T>::empty()
+{ return size() == 0; }
+
+
+
+template <typename T>
+T * MappedVector<T>::begin()
+{ return _array; }
+
+
+
+template <typename T>
+T * MappedVector<T>::end()
+{ return _array + size(); }
+
+
+
+template <typename T>
+void MappedVector<T>::clear()
+{ _header->size = 0; }                                                    // trivially copyable elements need no destruction
+
+
+
+template <typename T>
+void MappedVector<T>::flush()
+{
+  if( ::msync( _header, _mappedBytes, MS_SYNC ) != 0 ) fail( "msync" );
+}
+
+
+
+template <typename T>
+T & MappedVector<T>::at( std::size_t index )
+{
+  if( index >= size() ) throw std::range_error( "index out of bounds" );
+
+  return _array[index];
+}
+
+
+
+template <typename T>
+void MappedVector<T>::push_back( const T & value )
+{ insert( size(), value ); }                                              // delegate to insert() leveraging error checking
+
+
+
+template <typename T>
+void MappedVector<T>::push_back( T && value )
+{ insert( size(), std::move( value ) ); }                                 // delegate to insert() leveraging error checking
+
+
+
+template <typename T>
+template <typename... Args>
+T & MappedVector<T>::emplace_back( Args &&... args )
+{ return _array[ emplace( size(), std::forward<Args>( args )... ) ]; }    // delegate to emplace() leveraging error checking
+
+
+
+// Overloaded Array-Access Operator
+template <typename T>
+T & MappedVector<T>::operator[]( std::size_t index )
+{ return _array[index]; }                                                 // Note: array bounds intentionally not checked
+
+
+
+template <typename T>
+void MappedVector<T>::set( std::size_t index, const T & value )
+{ at( index ) = value; }                                                  // delegate to at() leveraging error checking
+
+
+
+template <typename T>
+void MappedVector<T>::set( std::size_t index, T && value )
+{ at( index ) = std::move( value ); }                                     // delegate to at() leveraging error checking
+
+
+
+// Removes element from position. Elements from higher positions are shifted back to fill gap.
+// Vector size decrements
+template <typename T>
+std::size_t MappedVector<T>::erase( std::size_t index )
+{ return erase( index, index + 1 ); }                                     // delegate to range erase leveraging error checking
+
+
+
+template <typename T>
+T * MappedVector<T>::erase( T * position )
+{
+  // delegate to delete by index
+  auto index = position - begin();                                        // Note the pointer arithmetic here
+  erase( index );
+  return begin() + index;
+}
+
+
+
+template <typename T>
+std::size_t MappedVector<T>::erase( std::size_t first, std::size_t last )
+{
+  if( first > last  ||  last > size() ) throw std::range_error( "index out of bounds" );
+
+  // shift the elements after the range left once, trivially copyable elements are copied as raw bytes
+  std::copy( _array + last, end(), _array + first );
+  _header->size -= last - first;
+
+  return first;
+}
+
+
+
+template <typename T>
+T * MappedVector<T>::erase( T * first, T * last )
+{
+  // delegate to delete by index
+  erase( first - begin(), last - begin() );                               // Note the pointer arithmetic here
+  return first;
+}
+
+
+
+// Keeps the elements predicate is false for in their original order, each copied at most once
+template <typename T>
+template <typename Predicate>
+std::size_t MappedVector<T>::erase_if( Predicate predicate )
+{
+  auto kept    = std::remove_if( begin(), end(), predicate );
+  auto removed = static_cast<std::size_t>( end() - kept );
+
+  _header->size -= removed;
+  return removed;
+}
+
+
+
+// Copies x to element at position. Items at that position and higher are shifted over to make room. Vector size increments.
+template <typename T>
+std::size_t MappedVector<T>::insert( std::size_t beforeIndex, const T & value )
+{ return emplace( beforeIndex, value ); }
+
+
+
+template <typename T>
+std::size_t MappedVector<T>::insert( std::size_t beforeIndex, T && value )
+{ return emplace( beforeIndex, std::move( value ) ); }
+
+
+
+// Constructs a new element from args at position.  Items at that position and higher are shifted over to make room.  Vector size
+// increments.  The new element is made before anything moves, since args may refer to an element of this vector and growth remaps
+template <typename T>
+template <typename... Args>
+std::size_t MappedVector<T>::emplace( std::size_t beforeIndex, Args &&... args )
+{
+  T element( std::forward<Args>( args )... );
+
+  auto oldSize = size();
+  if( beforeIndex > oldSize              ) beforeIndex = oldSize;         // insert at the back
+  if( oldSize    == _header->capacity    ) reserve( std::max<std::size_t>( 2 * oldSize, 1 ) );   // full, double the capacity
+
+  std::copy_backward( _array + beforeIndex, _array + oldSize, _array + oldSize + 1 );
+  _array[beforeIndex] = element;
+  _header->size       = oldSize + 1;
+
+  return beforeIndex;
+}
+
+
+
+template <typename T>
+T * MappedVector<T>::insert( T * beforePosition, const T & value )
+{ return begin() + insert( static_cast<std::size_t>( beforePosition - begin() ), value ); }
+
+
+
+template <typename T>
+T * MappedVector<T>::insert( T * beforePosition, T && value )
+{ return begin() + insert( static_cast<std::size_t>( beforePosition - begin() ), std::move( value ) ); }
+
+
+
+template <typename T>
+template <typename... Args>
+T * MappedVector<T>::emplace( T * beforePosition, Args &&... args )
+{ return begin() + emplace( static_cast<std::size_t>( beforePosition - begin() ), std::forward<Args>( args )... ); }
+
+
+
+// The new elements are appended in one pass, then a single rotation moves them into place shifting the elements after them
+template <typename T>
+template <typename InputIterator>
+std::size_t MappedVector<T>::insert( std::size_t beforeIndex, InputIterator first, InputIterator last )
+{
+  if( beforeIndex > size() ) beforeIndex = size();                        // insert at the back
+
+  auto oldSize = size();
+  append( first, last );
+  std::rotate( begin() + beforeIndex, begin() + oldSize, end() );
+
+  return beforeIndex;
+}
+
+
+
+template <typename T>
+template <typename InputIterator>
+T * MappedVector<T>::insert( T * beforePosition, InputIterator first, InputIterator last )
+{ return begin() + insert( static_cast<std::size_t>( beforePosition - begin() ), first, last ); }
+
+
+
+// When the range can be measured up front, the file is extended at most once.  Otherwise elements are added one at a time.  Either
+// way, if adding an element fails the elements already added are removed again
+template <typename T>
+template <typename InputIterator>
+void MappedVector<T>::append( InputIterator first, InputIterator last )
+{
+  using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  if constexpr( std::is_base_of_v<std::forward_iterator_tag, Category> )
+  {
+    auto newSize = size() + static_cast<std::size_t>( std::distance( first, last ) );
+    if( newSize > _header->capacity ) reserve( std::max<std::size_t>( newSize, 2 * _header->capacity ) );
+  }
+
+  auto oldSize = size();
+  try
+  {
+    for( ;  first != last;  ++first ) emplace_back( *first );
+  }
+  catch( ... )
+  {
+    _header->size = oldSize;
+    throw;
+  }
+}
+
+
+
+// The file is extended first, so if the remap fails the vector is still whole, just with room it can't use yet.  On Linux mremap()
+// moves the mapping if it can't be extended in place, elsewhere the file is mapped afresh
+template <typename T>
+void MappedVector<T>::reserve( std::size_t newCapacity )
+{
+  auto newBytes = fileBytes( newCapacity );
+  if( newBytes <= _mappedBytes ) return;
+
+  if( ::ftruncate( _file, static_cast<off_t>( newBytes ) ) != 0 ) fail( "ftruncate" );
+
+  #ifdef __linux__
+    void * mapping = ::mremap( _header, _mappedBytes, newBytes, MREMAP_MAYMOVE );
+    if( mapping == MAP_FAILED ) fail( "mremap" );
+  #else
+    void * mapping = ::mmap( nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0 );
+    if( mapping == MAP_FAILED ) fail( "mmap" );
+    ::munmap( _header, _mappedBytes );
+  #endif
+
+  _header           = static_cast<Header *>( mapping );
+  _array            = reinterpret_cast<T *>( static_cast<char *>( mapping ) + HEADER_BYTES );
+  _mappedBytes      = newBytes;
+  _header->capacity = newCapacity;
+}
+
+
+
+template <typename T>
+void MappedVector<T>::release()
+{
+  if( _header != nullptr ) ::munmap( _header, _mappedBytes );
+  if( _file   >= 0       ) ::close ( _file );
+
+  _file        = -1;
+  _header      = nullptr;
+  _array       = nullptr;
+  _mappedBytes = 0;
+}
+
+
+
+template <typename T>
+std::size_t MappedVector<T>::fileBytes( std::size_t capacity )
+{ return HEADER_BYTES + capacity * sizeof( T ); }
+
+
+
+template <typename T>
+void MappedVector<T>::fail( const char * operation )
+{ throw std::system_error( errno, std::generic_category(), operation ); }
+
+
+
+// Move Constructor
+template <typename T>
+MappedVector<T>::MappedVector( MappedVector<T> && other ) noexcept
+: _file       ( std::exchange( other._file,        -1      ) ),
+  _header     ( std::exchange( other._header,      nullptr ) ),
+  _array      ( std::exchange( other._array,       nullptr ) ),
+  _mappedBytes( std::exchange( other._mappedBytes, 0       ) )
+{}                                                                        // other is left with no file at all
+
+
+
+// Move Assignment Operator
+template<typename T>
+MappedVector<T> & MappedVector<T>::operator=( MappedVector<T> && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    release();
+
+    _file        = std::exchange( rhs._file,        -1      );
+    _header      = std::exchange( rhs._header,      nullptr );
+    _array       = std::exchange( rhs._array,       nullptr );
+    _mappedBytes = std::exchange( rhs._mappedBytes, 0       );
+  }
+
+  return *this;
+}
+
+
+
+// Destructor
+template <typename T>
+MappedVector<T>::~MappedVector()
+{ release(); }
@@ -0,0 +1,637 @@
+#pragma once
+#include <algorithm>    // move(), find()
+#include <cstddef>      // size_t
+#include <iostream>
+#include <memory>       // allocator, uninitialized_move()
+#include <new>          // placement new
+#include <stdexcept>    // invalid_argument
+#include <type_traits>  // is_nothrow_move_constructible
+#include <utility>      // move(), forward(), exchange()
+
+#include "BinarySearchTree.hpp"
+
+/*******************************************************************************
+**  Value Bucket
+**
+**  The values stored under one key, in insertion order.  The first InlineCapacity values live inside the bucket itself, so the
+**  common case of a key with only one or two values needs no allocation beyond the tree node.  More values spill into a single heap
+**  array that doubles as it fills.
+*******************************************************************************/
+template <typename Value, std::size_t InlineCapacity = 2>
+class ValueBucket {
+  public:
+    ValueBucket             () = default;
+    ValueBucket             ( const ValueBucket & original );
+    ValueBucket             (       ValueBucket && original ) noexcept( std::is_nothrow_move_constructible_v<Value> );
+    ValueBucket & operator= (       ValueBucket    rhs      );              // NOTE: INTENTIONALLY PASSED BY VALUE (delegates to copy or move constructor)
+   ~ValueBucket             ();
+
+    template <typename... Args>
+    Value & emplace_back( Args &&... args );                                // Appends a value constructed in place from args
+    void    erase       ( std::size_t index );                              // Removes the value at index, later values keep their order
+
+    std::size_t size ()                    const;
+    bool        empty()                    const;
+    Value       & operator[]( std::size_t index );                          // No bounds checking
+    const Value & operator[]( std::size_t index ) const;
+
+    Value       * begin();                                                  // Values are contiguous, so plain pointers serve as iterators
+    Value       * end  ();
+    const Value * begin() const;
+    const Value * end  () const;
+
+
+  private:
+    alignas( Value ) unsigned char inline_[ InlineCapacity * sizeof( Value ) ];
+
+    Value *     data_     = reinterpret_cast<Value *>( inline_ );          // inline_ until the first spill
+    std::size_t size_     = 0;
+    std::size_t capacity_ = InlineCapacity;
+
+    bool isInline() const;
+    void destroy ();                                                        // Destroys every value and releases any heap array, leaving the bucket unusable until reset
+    void takeOver( ValueBucket & original );                                // Moves original's values into this empty bucket, leaving original empty.  Neither changes if a move throws
+  };
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Multimap Binary Search Tree (Duplicate keys share one node)
+**
+**  BinarySearchTree gives every duplicate key its own node, so heavily duplicated keys inflate both the tree's height and its memory.
+**  This tree keeps one node per distinct key holding a ValueBucket of all that key's values.  Node count and height track the number
+**  of distinct keys, not the number of records.  Values under a key are kept in insertion order, so search() and remove( key ) act on
+**  the first inserted value exactly as BinarySearchTree's do.
+**
+**  Iterators visit each distinct key once and dereference to its bucket, read-only as emptying a bucket through one would leave the
+**  record count wrong and an empty bucket in the tree.
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance = BalancePolicy::NONE, AllocationPolicy Allocation = AllocationPolicy::HEAP>
+class MultiBinarySearchTree {
+  public:
+    using Bucket   = ValueBucket<Value>;
+    using Tree     = BinarySearchTree<Key, Bucket, Balance, Allocation>;
+    class Iterator;                                                         // A read-only bidirectional inorder iterator over the buckets
+
+    MultiBinarySearchTree             () = default;
+    MultiBinarySearchTree             ( const MultiBinarySearchTree & original ) = default;   // performs a deep copy
+    MultiBinarySearchTree             (       MultiBinarySearchTree && original ) noexcept;   // O(1), leaving original empty
+    MultiBinarySearchTree & operator= (       MultiBinarySearchTree    rhs      );            // NOTE: INTENTIONALLY PASSED BY VALUE (delegates to copy or move constructor)
+
+    // Queries
+    Value          search      ( const Key & key ) const;                   // Returns the first inserted value for key.  Throws invalid_argument if key not found
+    std::size_t    count       ( const Key & key ) const;                   // Returns the number of values stored under key
+    const Bucket & values      ( const Key & key ) const;                   // Returns all values stored under key in insertion order, an empty bucket if key not found
+    std::size_t    size        ()                  const;                   // Returns the number of (key, value) records.  O(1)
+    std::size_t    distinctKeys()                  const;                   // Returns the number of distinct keys, which is the number of nodes.  O(1)
+    int            getHeight   ()                  const;                   // Returns the height of the tree, or -1 if tree is empty.  O(1)
+    void           printInorder()                  const;                   // Prints every key with its values in ascending key order
+
+    // Updates, each O(log k) for k distinct keys with the AVL and RED_BLACK policies, O(log k) amortized with SPLAY, and O(k) in the
+    // worst case with NONE
+    void        insert   ( const Key & key, const Value & value );          // Appends value to key's bucket, adding the key if it's new
+    void        insert   (       Key && key,       Value && value );
+    void        remove   ( const Key & key );                               // Removes the first inserted value under key, if any
+    bool        remove   ( const Key & key, const Value & value );          // Removes the first value under key equal to value.  Returns false if there was none
+    std::size_t removeAll( const Key & key );                               // Removes key and all its values.  Returns the number of values removed
+    void        clear    ();
+
+    Iterator begin      ()                  const;
+    Iterator end        ()                  const;
+    Iterator lower_bound( const Key & key ) const;
+    Iterator upper_bound( const Key & key ) const;
+
+
+  private:
+    Tree        tree_;
+    std::size_t size_ = 0;                                                  // total values in all buckets
+
+    template <typename KeyArg, typename ValueArg>
+    void append( KeyArg && key, ValueArg && value );
+    void removeAt( Bucket & bucket, const Key & key, std::size_t index );   // Removes one value, and the key once its bucket is empty
+  };
+
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  Multimap Binary Search Tree bidirectional inorder iterator.  Wraps the underlying tree's ConstIterator, so the buckets can only be
+**  read.
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+class MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator
+{
+  friend class MultiBinarySearchTree<Key, Value, Balance, Allocation>;
+
+  public:
+    Iterator() = default;
+
+    Iterator & operator++();                                                // advance to the next larger key (pre -increment)
+    Iterator   operator++( int );                                           // advance to the next larger key (post-increment)
+
+    Iterator & operator--();                                                // retreat to the next smaller key (pre -decrement).  Decrementing end() moves to the largest key
+    Iterator   operator--( int );                                           // retreat to the next smaller key (post-decrement)
+
+    const Key &    key      () const;                                       // Key at the current position
+    const Bucket & values   () const;                                       // All values stored under the current key, in insertion order
+    const Bucket & operator*() const;
+    const Bucket * operator->() const;
+
+    bool operator==( const Iterator & rhs ) const;
+    bool operator!=( const Iterator & rhs ) const;
+
+  private:
+    Iterator( typename Tree::ConstIterator position );
+
+    typename Tree::ConstIterator position_;
+};
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  ValueBucket<Value, InlineCapacity>  Definitions
+*******************************************************************************/
+template <typename Value, std::size_t InlineCapacity>
+ValueBucket<Value, InlineCapacity>::ValueBucket( const ValueBucket & original )
+{
+  try
+  {
+    for( const auto & value : original ) emplace_back( value );
+  }
+  catch( ... )                                                    // the destructor won't run for a partly constructed bucket
+  {
+    destroy();
+    throw;
+  }
+}
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+ValueBucket<Value, InlineCapacity>::ValueBucket( ValueBucket && original ) noexcept( std::is_nothrow_move_constructible_v<Value> )
+{ takeOver( original ); }
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+ValueBucket<Value, InlineCapacity> & ValueBucket<Value, InlineCapacity>::operator=( ValueBucket rhs )
+{
+  destroy();
+  data_     = reinterpret_cast<Value *>( inline_ );               // empty again, so the bucket stays usable if moving rhs's values throws
+  size_     = 0;
+  capacity_ = InlineCapacity;
+
+  takeOver( rhs );
+  return *this;
+}
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+ValueBucket<Value, InlineCapacity>::~ValueBucket()
+{ destroy(); }
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+void ValueBucket<Value, InlineCapacity>::destroy()
+{
+  std::destroy( begin(), end() );
+  if( !isInline() ) std::allocator<Value>().deallocate( data_, capacity_ );
+}
+
+
+
+
+// The new value is constructed before the existing values are moved, so args may safely refer to one of them
+template <typename Value, std::size_t InlineCapacity>
+template <typename... Args>
+Value & ValueBucket<Value, InlineCapacity>::emplace_back( Args &&... args )
+{
+  if( size_ < capacity_ )
+  {
+    auto value = new( data_ + size_ ) Value( std::forward<Args>( args )... );   // counted only once it has been constructed
+    ++size_;
+    return *value;
+  }
+
+  std::allocator<Value> allocator;
+  auto newCapacity = 2 * capacity_;
+  auto newData     = allocator.allocate( newCapacity );
+
+  try                  { new( newData + size_ ) Value( std::forward<Args>( args )... ); }
+  catch( ... )         { allocator.deallocate( newData, newCapacity );  throw; }
+
+  try                  { std::uninitialized_move( begin(), end(), newData ); }   // destroys the values already moved if one throws
+  catch( ... )         { newData[ size_ ].~Value();  allocator.deallocate( newData, newCapacity );  throw; }
+  destroy();
+
+  data_     = newData;
+  capacity_ = newCapacity;
+  return data_[ size_++ ];
+}
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+void ValueBucket<Value, InlineCapacity>::erase( std::size_t index )
+{
+  std::move( begin() + index + 1, end(), begin() + index );
+  data_[ --size_ ].~Value();
+}
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+void ValueBucket<Value, InlineCapacity>::takeOver( ValueBucket & original )
+{
+  if( original.isInline() )                                       // inline values must be moved one by one, a heap array is simply taken over
+  {
+    std::uninitialized_move( original.begin(), original.end(), data_ );   // destroys the values already moved if one throws
+    size_ = original.size_;
+    original.destroy();
+  }
+  else
+  {
+    data_     = original.data_;
+    size_     = original.size_;
+    capacity_ = original.capacity_;
+  }
+
+  original.data_     = reinterpret_cast<Value *>( original.inline_ );
+  original.size_     = 0;
+  original.capacity_ = InlineCapacity;
+}
+
+
+
+
+template <typename Value, std::size_t InlineCapacity>
+bool ValueBucket<Value, InlineCapacity>::isInline() const
+{ return data_ == reinterpret_cast<const Value *>( inline_ ); }
+
+
+
+template <typename Value, std::size_t InlineCapacity>  std::size_t   ValueBucket<Value, InlineCapacity>::size () const                           { return size_;         }
+template <typename Value, std::size_t InlineCapacity>  bool          ValueBucket<Value, InlineCapacity>::empty() const                           { return size_ == 0;    }
+template <typename Value, std::size_t InlineCapacity>  Value       & ValueBucket<Value, InlineCapacity>::operator[]( std::size_t index )         { return data_[index];  }
+template <typename Value, std::size_t InlineCapacity>  const Value & ValueBucket<Value, InlineCapacity>::operator[]( std::size_t index ) const   { return data_[index];  }
+template <typename Value, std::size_t InlineCapacity>  Value       * ValueBucket<Value, InlineCapacity>::begin()                                 { return data_;         }
+template <typename Value, std::size_t InlineCapacity>  Value       * ValueBucket<Value, InlineCapacity>::end  ()                                 { return data_ + size_; }
+template <typename Value, std::size_t InlineCapacity>  const Value * ValueBucket<Value, InlineCapacity>::begin() const                           { return data_;         }
+template <typename Value, std::size_t InlineCapacity>  const Value * ValueBucket<Value, InlineCapacity>::end  () const                           { return data_ + size_; }
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  MultiBinarySearchTree<Key, Value, Balance, Allocation>  Definitions
+*******************************************************************************/
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+MultiBinarySearchTree<Key, Value, Balance, Allocation>::MultiBinarySearchTree( MultiBinarySearchTree && original ) noexcept
+  : tree_( std::move( original.tree_ ) ),
+    size_( std::exchange( original.size_, 0 ) )
+{}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+MultiBinarySearchTree<Key, Value, Balance, Allocation> & MultiBinarySearchTree<Key, Value, Balance, Allocation>::operator=( MultiBinarySearchTree rhs )
+{
+  tree_ = std::move( rhs.tree_ );
+  size_ = rhs.size_;
+  return *this;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Queries
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+Value MultiBinarySearchTree<Key, Value, Balance, Allocation>::search( const Key & key ) const
+{
+  auto bucket = tree_.find( key );
+  if( bucket == nullptr ) throw std::invalid_argument( "Key not found" );
+
+  return ( *bucket )[ 0 ];                                        // buckets in the tree are never empty
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t MultiBinarySearchTree<Key, Value, Balance, Allocation>::count( const Key & key ) const
+{
+  auto bucket = tree_.find( key );
+  return bucket == nullptr ? 0 : bucket->size();
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Bucket & MultiBinarySearchTree<Key, Value, Balance, Allocation>::values( const Key & key ) const
+{
+  static const Bucket none{};
+
+  auto bucket = tree_.find( key );
+  return bucket == nullptr ? none : *bucket;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t MultiBinarySearchTree<Key, Value, Balance, Allocation>::size() const
+{ return size_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t MultiBinarySearchTree<Key, Value, Balance, Allocation>::distinctKeys() const
+{ return tree_.size(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+int MultiBinarySearchTree<Key, Value, Balance, Allocation>::getHeight() const
+{ return tree_.getHeight(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::printInorder() const
+{
+  for( auto entry = tree_.begin();  entry != tree_.end();  ++entry )
+  {
+    std::cout << "Key: \"" << entry.key() << "\",  Values:";
+    for( const auto & value : *entry ) std::cout << " \"" << value << '"';
+    std::cout << '\n';
+  }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Updates
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::insert( const Key & key, const Value & value )
+{ append( key, value ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::insert( Key && key, Value && value )
+{ append( std::move( key ), std::move( value ) ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+template <typename KeyArg, typename ValueArg>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::append( KeyArg && key, ValueArg && value )
+{
+  auto bucket = tree_.find( key );
+  if( bucket != nullptr )
+  {
+    bucket->emplace_back( std::forward<ValueArg>( value ) );
+  }
+  else
+  {
+    auto added = tree_.emplace( std::forward<KeyArg>( key ) );
+    try
+    {
+      added->emplace_back( std::forward<ValueArg>( value ) );
+    }
+    catch( ... )                                                  // buckets in the tree are never empty
+    {
+      tree_.remove( added.key() );
+      throw;
+    }
+  }
+  ++size_;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::remove( const Key & key )
+{
+  if( auto bucket = tree_.find( key ) ) removeAt( *bucket, key, 0 );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool MultiBinarySearchTree<Key, Value, Balance, Allocation>::remove( const Key & key, const Value & value )
+{
+  auto bucket = tree_.find( key );
+  if( bucket == nullptr ) return false;
+
+  auto match = std::find( bucket->begin(), bucket->end(), value );
+  if( match == bucket->end() ) return false;
+
+  removeAt( *bucket, key, match - bucket->begin() );
+  return true;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+std::size_t MultiBinarySearchTree<Key, Value, Balance, Allocation>::removeAll( const Key & key )
+{
+  auto removed = count( key );
+  if( removed != 0 )
+  {
+    tree_.remove( key );
+    size_ -= removed;
+  }
+  return removed;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::removeAt( Bucket & bucket, const Key & key, std::size_t index )
+{
+  bucket.erase( index );
+  --size_;
+
+  if( bucket.empty() ) tree_.remove( key );
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+void MultiBinarySearchTree<Key, Value, Balance, Allocation>::clear()
+{
+  tree_.clear();
+  size_ = 0;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Iterators
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator MultiBinarySearchTree<Key, Value, Balance, Allocation>::begin() const
+{ return tree_.begin(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator MultiBinarySearchTree<Key, Value, Balance, Allocation>::end() const
+{ return tree_.end(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator MultiBinarySearchTree<Key, Value, Balance, Allocation>::lower_bound( const Key & key ) const
+{ return tree_.lower_bound( key ); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator MultiBinarySearchTree<Key, Value, Balance, Allocation>::upper_bound( const Key & key ) const
+{ return tree_.upper_bound( key ); }
+
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::Iterator( typename Tree::ConstIterator position )
+  : position_( position )
+{}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator & MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator++()
+{
+  ++position_;
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator++( int )
+{
+  auto previous = *this;
+  ++position_;
+  return previous;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator & MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator--()
+{
+  --position_;
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator--( int )
+{
+  auto previous = *this;
+  --position_;
+  return previous;
+}
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const Key & MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::key() const
+{ return position_.key(); }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Bucket & MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::values() const
+{ return *position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Bucket & MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator*() const
+{ return *position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+const typename MultiBinarySearchTree<Key, Value, Balance, Allocation>::Bucket * MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator->() const
+{ return &*position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator==( const Iterator & rhs ) const
+{ return position_ == rhs.position_; }
+
+
+
+
+template <typename Key, typename Value, BalancePolicy Balance, AllocationPolicy Allocation>
+bool MultiBinarySearchTree<Key, Value, Balance, Allocation>::Iterator::operator!=( const Iterator & rhs ) const
+{ return position_ != rhs.position_; }
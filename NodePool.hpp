@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>                                                      // max()
+#include <cstddef>                                                        // size_t
+#include <new>                                                            // operator new(), operator delete()
+#include <utility>                                                        // swap()
+
+
+
+
+/*******************************************************************************
+** A slab allocator for fixed size nodes
+**
+** Storage for SlabCapacity nodes is requested from the heap at once, and nodes are handed out from the newest slab one after another
+** so nodes allocated together sit next to each other in memory.  Released nodes are threaded onto an intrusive free list (the
+** "next" pointer is stored inside the unused node's own storage) and are recycled before any new slab is carved.  release() returns
+** every slab to the heap in O(#slabs) without visiting individual nodes.
+**
+** reserve() lets a caller that knows how many nodes it is about to allocate get them all from a single slab.
+**
+** The pool hands out uninitialized storage.  Constructing and destroying the objects living there is the caller's responsibility.
+*******************************************************************************/
+template <typename T, std::size_t SlabCapacity = 1024>
+class NodePool
+{
+  public:
+    NodePool            (                  ) = default;
+    NodePool            ( const NodePool & ) = delete;                    // slabs are owned, not shared
+    NodePool & operator=( const NodePool & ) = delete;
+   ~NodePool            ();                                               // releases all slabs
+
+    void * allocate  ();                                                  // Returns uninitialized storage for one T
+    void   reserve   ( std::size_t count );                               // Ensures the next count allocations come from one slab without further heap requests
+    void   deallocate( void * storage );                                  // Returns storage (object already destroyed) to the free list
+    void   release   ();                                                  // Returns all slabs to the heap. Objects must already be destroyed or be trivially destructible
+    void   swap      ( NodePool & other ) noexcept;
+    void   merge     ( NodePool & other );                                // Takes ownership of other's slabs and recycled slots, leaving other empty
+
+
+  private:
+    union Slot
+    {
+      Slot *                             next_;                           // valid only while the slot is on the free list
+      alignas( T ) unsigned char         storage_[ sizeof( T ) ];         // valid only while the slot is handed out
+    };
+
+    struct Slab                                                           // header followed by capacity_ slots in the same heap block
+    {
+      Slab *      next_;
+      std::size_t capacity_;
+
+      Slot * slots();
+    };
+
+    static constexpr std::size_t SLOTS_OFFSET = ( sizeof( Slab ) + alignof( Slot ) - 1 ) / alignof( Slot ) * alignof( Slot );
+
+    Slab *      slabs_    = nullptr;                                      // singly linked list of slabs, newest first
+    Slot *      freeList_ = nullptr;                                      // singly linked list of recycled slots
+    std::size_t carved_   = 0;                                            // number of slots handed out from the newest slab
+
+    void addSlab( std::size_t capacity );
+};
+
+
+
+
+
+
+// Implementation
+
+template <typename T, std::size_t SlabCapacity>
+NodePool<T, SlabCapacity>::~NodePool()
+{ release(); }
+
+
+
+template <typename T, std::size_t SlabCapacity>
+void * NodePool<T, SlabCapacity>::allocate()
+{
+  if( freeList_ != nullptr )                                              // recycle a released slot first
+  {
+    auto slot = freeList_;
+    freeList_ = slot->next_;
+    return slot->storage_;
+  }
+
+  if( slabs_ == nullptr  ||  carved_ == slabs_->capacity_ ) addSlab( SlabCapacity );   // newest slab exhausted, get another one
+
+  return slabs_->slots()[ carved_++ ].storage_;
+}
+
+
+
+// Any slots left in the current newest slab stay unused until the pool is released
+template <typename T, std::size_t SlabCapacity>
+void NodePool<T, SlabCapacity>::reserve( std::size_t count )
+{
+  if( slabs_ == nullptr  ||  slabs_->capacity_ - carved_ < count ) addSlab( std::max( count, SlabCapacity ) );
+}
+
+
+
+template <typename T, std::size_t SlabCapacity>
+void NodePool<T, SlabCapacity>::addSlab( std::size_t capacity )
+{
+  auto memory = ::operator new( SLOTS_OFFSET + capacity * sizeof( Slot ) );   // slots are trivial, so only the header is constructed
+
+  slabs_  = new( memory ) Slab{ slabs_, capacity };
+  carved_ = 0;
+}
+
+
+
+template <typename T, std::size_t SlabCapacity>
+typename NodePool<T, SlabCapacity>::Slot * NodePool<T, SlabCapacity>::Slab::slots()
+{ return reinterpret_cast<Slot *>( reinterpret_cast<unsigned char *>( this ) + SLOTS_OFFSET ); }
+
+
+
+template <typename T, std::size_t SlabCapacity>
+void NodePool<T, SlabCapacity>::deallocate( void * storage )
+{
+  if( storage == nullptr ) return;
+
+  auto slot   = static_cast<Slot *>( storage );                           // storage_ is at offset 0 of the union
+  slot->next_ = freeList_;
+  freeList_   = slot;
+}
+
+
+
+template <typename T, std::size_t SlabCapacity>
+void NodePool<T, SlabCapacity>::release()
+{
+  while( slabs_ != nullptr )
+  {
+    auto next = slabs_->next_;
+    ::operator delete( slabs_ );
+    slabs_ = next;
+  }
+
+  freeList_ = nullptr;
+  carved_   = 0;
+}
+
+
+
+// other's slabs are linked in behind this pool's newest slab so allocation continues where it was.  Slots never carved from other's
+// newest slab stay unused until the pool is released.
+template <typename T, std::size_t SlabCapacity>
+void NodePool<T, SlabCapacity>::merge( NodePool & other )
+{
+  if( this == &other  ||  other.slabs_ == nullptr ) return;
+
+  if( slabs_ == nullptr ) swap( other );
+  else
+  {
+    auto lastSlab = other.slabs_;
+    while( lastSlab->next_ != nullptr ) lastSlab = lastSlab->next_;
+    lastSlab->next_ = slabs_->next_;
+    slabs_->next_   = other.slabs_;
+
+    if( other.freeList_ != nullptr )
+    {
+      auto lastSlot = other.freeList_;
+      while( lastSlot->next_ != nullptr ) lastSlot = lastSlot->next_;
+      lastSlot->next_ = freeList_;
+      freeList_       = other.freeList_;
+    }
+  }
+
+  other.slabs_    = nullptr;
+  other.freeList_ = nullptr;
+  other.carved_   = 0;
+}
+
+
+
+template <typename T, std::size_t SlabCapacity>
+void NodePool<T, SlabCapacity>::swap( NodePool & other ) noexcept
+{
+  std::swap( slabs_,    other.slabs_    );
+  std::swap( freeList_, other.freeList_ );
+  std::swap( carved_,   other.carved_   );
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>                                                      // sort(), merge(), move(), min(), max(), for_each(), transform()
+#include <cstddef>                                                        // size_t
+#include <functional>                                                     // less, plus
+#include <iterator>                                                       // iterator_traits, make_move_iterator()
+#include <numeric>                                                        // accumulate()
+#include <optional>
+#include <vector>
+
+#include "TaskPool.hpp"
+
+
+
+
+/*******************************************************************************
+** Parallel versions of sort, transform, reduce, and for_each over random access ranges, such as an ExtendableVector's [begin(), end())
+**
+** Each algorithm splits the range into pieces of at least grain elements and runs the pieces on the shared TaskPool, so
+** TaskPool::instance().setConcurrency() limits the threads they use.  Ranges of grain elements or fewer, and calls made from inside
+** another parallel task, run serially on the calling thread.  A smaller grain spreads work more evenly across threads, a larger one
+** costs less in scheduling.  The first exception thrown by an element operation is rethrown once every piece has stopped.
+**
+**   sort     - a parallel merge sort: each thread sorts one run, then pairs of runs are merged until one is left.  Each merge is
+**              itself split into pieces, so the last merge of the whole range keeps every thread busy too.  Not stable, and needs a
+**              buffer as large as the range.  If compare, or moving an element, throws, the range is left holding unspecified values
+**   transform- writes op( element ) for each element to the range starting at out, returns the end of the output range.  out must
+**              be a random access iterator to at least as many elements as the input, already in place, so an inserter such as
+**              back_inserter won't do
+**   reduce   - combines init and every element with op, which must be associative.  The elements are combined in order, so op
+**              need not be commutative
+**   for_each - calls f( element ) for every element, in no particular order
+*******************************************************************************/
+namespace Parallel
+{
+  constexpr std::size_t DEFAULT_GRAIN = 1 << 14;                          // elements
+
+  template<typename RandomIterator, typename Compare = std::less<>>
+  void sort( RandomIterator first, RandomIterator last, Compare compare = Compare(), std::size_t grain = DEFAULT_GRAIN );
+
+  template<typename RandomIterator, typename RandomOutputIterator, typename UnaryOperation>
+  RandomOutputIterator transform( RandomIterator first, RandomIterator last, RandomOutputIterator out, UnaryOperation op, std::size_t grain = DEFAULT_GRAIN );
+
+  template<typename RandomIterator, typename T, typename BinaryOperation = std::plus<>>
+  T reduce( RandomIterator first, RandomIterator last, T init, BinaryOperation op = BinaryOperation(), std::size_t grain = DEFAULT_GRAIN );
+
+  template<typename RandomIterator, typename Function>
+  void for_each( RandomIterator first, RandomIterator last, Function f, std::size_t grain = DEFAULT_GRAIN );
+}
+
+
+
+
+
+
+// Implementation
+
+namespace Parallel
+{
+  // Number of pieces of at least grain elements to split count elements into
+  inline std::size_t pieces( std::size_t count, std::size_t grain )
+  { return std::max<std::size_t>( count / std::max<std::size_t>( grain, 1 ), 1 ); }
+
+
+
+  // The number of elements of a taken by the first d elements of the stable merge of a (m elements) and b (n elements).  Elements of
+  // a that are equivalent to elements of b come first
+  template<typename Iterator, typename Compare>
+  std::size_t coRank( std::size_t d, Iterator a, std::size_t m, Iterator b, std::size_t n, Compare & compare )
+  {
+    std::size_t low  = d > n ? d - n : 0;
+    std::size_t high = std::min( d, m );
+    while( low < high )
+    {
+      std::size_t i = low + ( high - low ) / 2;                           // takes a[0, i) and b[0, d - i), so a[i] and b[d-i-1] exist
+      if( !compare( b[ d - i - 1 ], a[ i ] ) ) low  = i + 1;              // a[i] belongs before b[d-i-1], more of a is needed
+      else                                     high = i;
+    }
+    return low;
+  }
+
+
+
+  // Merges each pair of adjacent runs of width elements in source into runs of 2 * width in destination.  Every merge is split into
+  // pieces of about grain output elements, and all pieces of all pairs are handed to the pool as one job.  Where each piece starts is
+  // found by co-ranking first, as a job of its own, because merging moves elements out of the source that other pieces' co-ranking
+  // would otherwise still be comparing
+  template<typename Source, typename Destination, typename Compare>
+  void mergeRuns( Source source, Destination destination, std::size_t count, std::size_t width, Compare & compare, std::size_t grain )
+  {
+    std::size_t pairs         = ( count + 2 * width - 1 ) / ( 2 * width );
+    std::size_t piecesPerPair = pieces( std::min( 2 * width, count ), grain );
+
+    // The pair's runs, a and b, and where the piece's output starts in the merge of the two
+    auto locate = [&]( std::size_t task, std::size_t & pairStart, std::size_t & m, std::size_t & n, std::size_t & outFirst )
+    {
+      pairStart = task / piecesPerPair * 2 * width;
+      m         = std::min( width, count - pairStart );                   // the last pair may be short, or a lone run
+      n         = std::min( width, count - pairStart - m );
+      outFirst  = ( m + n ) * ( task % piecesPerPair ) / piecesPerPair;
+    };
+
+    std::vector<std::size_t> aFirst( pairs * piecesPerPair );             // elements of a before each piece
+    TaskPool::instance().parallelFor( aFirst.size(), [&]( std::size_t task )
+    {
+      std::size_t pairStart, m, n, outFirst;
+      locate( task, pairStart, m, n, outFirst );
+      aFirst[ task ] = coRank( outFirst, source + pairStart, m, source + pairStart + m, n, compare );
+    } );
+
+    TaskPool::instance().parallelFor( aFirst.size(), [&]( std::size_t task )
+    {
+      std::size_t pairStart, m, n, outFirst;
+      locate( task, pairStart, m, n, outFirst );
+
+      bool        lastPiece = ( task + 1 ) % piecesPerPair == 0;          // the next piece belongs to the next pair
+      std::size_t outLast   = ( m + n ) * ( task % piecesPerPair + 1 ) / piecesPerPair;
+      std::size_t aLast     = lastPiece ? m : aFirst[ task + 1 ];
+      auto        a         = source + pairStart;
+      auto        b         = a      + m;
+
+      std::merge( std::make_move_iterator( a + aFirst[ task ] ),                std::make_move_iterator( a + aLast ),
+                  std::make_move_iterator( b + ( outFirst - aFirst[ task ] ) ), std::make_move_iterator( b + ( outLast - aLast ) ),
+                  destination + pairStart + outFirst, compare );
+    } );
+  }
+
+
+
+  template<typename RandomIterator, typename Compare>
+  void sort( RandomIterator first, RandomIterator last, Compare compare, std::size_t grain )
+  {
+    auto  count    = static_cast<std::size_t>( last - first );
+    auto  threads  = TaskPool::instance().concurrency();
+    if( count <= grain  ||  threads == 1 )
+    {
+      std::sort( first, last, compare );
+      return;
+    }
+
+    // One run per thread, each sorted serially
+    std::size_t width = std::max( grain, ( count + threads - 1 ) / threads );
+    std::size_t runs  = ( count + width - 1 ) / width;
+    TaskPool::instance().parallelFor( runs, [&]( std::size_t run )
+    {
+      std::sort( first + run * width, first + std::min( ( run + 1 ) * width, count ), compare );
+    } );
+
+    // Merge pairs of runs back and forth between the range and the buffer until one run is left
+    std::vector<typename std::iterator_traits<RandomIterator>::value_type> buffer( std::make_move_iterator( first ), std::make_move_iterator( last ) );
+    bool inBuffer = true;
+    for( ;  width < count;  width *= 2 )
+    {
+      if( inBuffer ) mergeRuns( buffer.begin(), first,          count, width, compare, grain );
+      else           mergeRuns( first,          buffer.begin(), count, width, compare, grain );
+      inBuffer = !inBuffer;
+    }
+
+    if( inBuffer )
+    {
+      auto tasks = pieces( count, grain );
+      TaskPool::instance().parallelFor( tasks, [&]( std::size_t task )
+      {
+        std::move( buffer.begin() + count * task / tasks, buffer.begin() + count * ( task + 1 ) / tasks, first + count * task / tasks );
+      } );
+    }
+  }
+
+
+
+  template<typename RandomIterator, typename RandomOutputIterator, typename UnaryOperation>
+  RandomOutputIterator transform( RandomIterator first, RandomIterator last, RandomOutputIterator out, UnaryOperation op, std::size_t grain )
+  {
+    auto count = static_cast<std::size_t>( last - first );
+    auto tasks = pieces( count, grain );
+
+    TaskPool::instance().parallelFor( tasks, [&]( std::size_t task )
+    {
+      std::size_t begin = count *   task       / tasks;
+      std::size_t end   = count * ( task + 1 ) / tasks;
+      std::transform( first + begin, first + end, out + begin, op );
+    } );
+
+    return out + count;
+  }
+
+
+
+  template<typename RandomIterator, typename T, typename BinaryOperation>
+  T reduce( RandomIterator first, RandomIterator last, T init, BinaryOperation op, std::size_t grain )
+  {
+    auto count = static_cast<std::size_t>( last - first );
+    auto tasks = pieces( count, grain );
+
+    // Each piece is reduced starting from its own first element, so op needs no identity value
+    std::vector<std::optional<T>> partials( tasks );
+    TaskPool::instance().parallelFor( tasks, [&]( std::size_t task )
+    {
+      std::size_t begin = count *   task       / tasks;
+      std::size_t end   = count * ( task + 1 ) / tasks;
+      if( begin != end ) partials[ task ] = std::accumulate( first + begin + 1, first + end, T( first[ begin ] ), op );
+    } );
+
+    for( auto & partial : partials ) if( partial ) init = op( std::move( init ), std::move( *partial ) );
+    return init;
+  }
+
+
+
+  template<typename RandomIterator, typename Function>
+  void for_each( RandomIterator first, RandomIterator last, Function f, std::size_t grain )
+  {
+    auto count = static_cast<std::size_t>( last - first );
+    auto tasks = pieces( count, grain );
+
+    TaskPool::instance().parallelFor( tasks, [&]( std::size_t task )
+    {
+      std::for_each( first + count * task / tasks, first + count * ( task + 1 ) / tasks, f );
+    } );
+  }
+}    // namespace Parallel
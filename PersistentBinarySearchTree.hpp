@@ -0,0 +1,381 @@
+#pragma once
+#include <algorithm>  // max()
+#include <cstddef>    // size_t
+#include <iostream>
+#include <memory>     // shared_ptr, make_shared(), atomic_load(), atomic_store()
+#include <mutex>
+#include <stdexcept>  // invalid_argument
+#include <utility>    // move(), swap()
+
+/*******************************************************************************
+**  Persistent (versioned) Binary Search Tree (Duplicate keys allowed)
+**
+**  Nodes are never modified once built.  insert() and remove() build new copies of only the O(log n) nodes on the path they touch
+**  (and of the few nodes they rotate) and share every other node with the previous version, so the old version stays intact.  Nodes
+**  are reference counted and released when the last version using them goes away.
+**
+**  A version is simply a tree object.  Copying a tree, or calling snapshot(), takes O(1) and yields a point-in-time view that later
+**  updates to the original never change.  Any number of threads may read any versions, and may take snapshots of a tree while one
+**  other thread at a time updates it.
+**
+**  The tree is AVL balanced.  Values are held by shared pointer so path copying copies keys but never values.  There are no parent
+**  pointers, a node shared by many versions has a different parent in each.
+*******************************************************************************/
+template <typename Key, typename Value>
+class PersistentBinarySearchTree {
+  public:
+    PersistentBinarySearchTree             () = default;
+    PersistentBinarySearchTree             ( const PersistentBinarySearchTree & original );   // O(1), shares all of original's nodes
+    PersistentBinarySearchTree & operator= ( PersistentBinarySearchTree rhs );                // O(1)  NOTE: INTENTIONALLY PASSED BY VALUE
+
+    // Queries (may be called from any thread)
+    Value       search   ( const Key & key )                 const;         // Returns the value associated with the first inserted matching key. Throws invalid_argument if key not found
+    bool        search   ( const Key & key, Value & value )  const;         // Copies the value associated with the first inserted matching key into value.  Returns false if key not found
+    std::size_t size     ()                                  const;         // Returns the number of entries in the tree.  O(1)
+    int         getHeight()                                  const;         // Returns the height of the tree, or -1 if tree is empty.  O(1)
+    void        printInorder()                               const;         // Prints the contents of the tree in ascending sorted order
+
+    template <typename Visitor>
+    void        forEach  ( Visitor visit )                   const;         // Calls visit( key, value ) for every entry in ascending key order, all from the same version
+
+    PersistentBinarySearchTree snapshot()                    const;         // Returns the current version.  O(1)
+
+    // Mutators (serialized with each other, never disturb snapshots or readers)
+    void insert( const Key & key, const Value & value );                    // Inserts a new entry, after any entries with an equal key.  O(log n)
+    void remove( const Key & key );                                         // Removes the first inserted matching entry, if any.  O(log n)
+
+
+  private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    NodePtr    root_;                                                       // read and replaced atomically, the current version
+    std::mutex writerMutex_;
+
+    NodePtr current() const;                                                // The current root, safe to call while a writer replaces it
+
+    // Path copying helper functions, each returns the root of the new version of the subtree
+    static NodePtr insert     ( const NodePtr & node, const Key & key, const std::shared_ptr<const Value> & value );
+    static NodePtr removeAt   ( const NodePtr & node, std::size_t index );  // Removes the entry with index entries before it in the subtree
+    static NodePtr removeFirst( const NodePtr & node, NodePtr & first );    // Removes the subtree's smallest entry, which is returned in first
+    static NodePtr balance    ( const Key & key, const std::shared_ptr<const Value> & value, const NodePtr & left, const NodePtr & right );   // Builds a node, rotating if the subtrees' heights differ by 2
+
+    static const Node * lowerBound( const NodePtr & root, const Key & key, std::size_t & index );   // First entry not less than key, and the number of entries before it
+
+    template <typename Visitor>
+    static void forEach( const Node * node, Visitor & visit );
+
+    static int         height( const NodePtr & node );                      // -1 for an empty subtree
+    static std::size_t size  ( const NodePtr & node );                      //  0 for an empty subtree
+  };
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  PersistentBinarySearchTree<Key, Value>::Node Definition
+*******************************************************************************/
+template <typename Key, typename Value>
+struct PersistentBinarySearchTree<Key, Value>::Node
+{
+  Node( const Key & key, std::shared_ptr<const Value> value, NodePtr left, NodePtr right )
+    : key_   ( key ),
+      value_ ( std::move( value ) ),
+      left_  ( std::move( left  ) ),
+      right_ ( std::move( right ) ),
+      height_( 1 + std::max( PersistentBinarySearchTree::height( left_ ), PersistentBinarySearchTree::height( right_ ) ) ),
+      size_  ( 1 +           PersistentBinarySearchTree::size  ( left_ ) +  PersistentBinarySearchTree::size  ( right_ ) )
+  {}
+
+  const Key                          key_;
+  const std::shared_ptr<const Value> value_;                              // shared by every copy of this entry's node
+  const NodePtr                      left_;
+  const NodePtr                      right_;
+  const int                          height_;
+  const std::size_t                  size_;
+};
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  PersistentBinarySearchTree<Key, Value>  Definitions
+*******************************************************************************/
+////////////////////////////////////////////////////////////////////////////////
+//   Constructors and assignments
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+PersistentBinarySearchTree<Key, Value>::PersistentBinarySearchTree( const PersistentBinarySearchTree & original )
+  : root_( original.current() )
+{}
+
+
+
+
+// rhs is already an O(1) copy, so assignment just publishes its root.  The replaced version's nodes are released once no other version
+// shares them.
+template <typename Key, typename Value>
+PersistentBinarySearchTree<Key, Value> & PersistentBinarySearchTree<Key, Value>::operator=( PersistentBinarySearchTree rhs )
+{
+  std::lock_guard<std::mutex> lock( writerMutex_ );
+
+  std::atomic_store( &root_, rhs.root_ );
+  return *this;
+}
+
+
+
+
+template <typename Key, typename Value>
+PersistentBinarySearchTree<Key, Value> PersistentBinarySearchTree<Key, Value>::snapshot() const
+{ return *this; }
+
+
+
+
+template <typename Key, typename Value>
+typename PersistentBinarySearchTree<Key, Value>::NodePtr PersistentBinarySearchTree<Key, Value>::current() const
+{ return std::atomic_load( &root_ ); }
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Search
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+Value PersistentBinarySearchTree<Key, Value>::search( const Key & key ) const
+{
+  Value value;
+  if( !search( key, value ) ) throw std::invalid_argument( "Key not found" );
+  return value;
+}
+
+
+
+
+//  The local root keeps the whole version alive while it's searched, even if a writer publishes a new one meanwhile
+template <typename Key, typename Value>
+bool PersistentBinarySearchTree<Key, Value>::search( const Key & key, Value & value ) const
+{
+  auto        root  = current();
+  std::size_t index = 0;
+
+  auto node = lowerBound( root, key, index );
+  if( node == nullptr  ||  !( node->key_ == key ) ) return false;
+
+  value = *node->value_;
+  return true;
+}
+
+
+
+
+//  Rotations may lift a later duplicate above earlier ones, so the search continues left past matches to the first inserted
+template <typename Key, typename Value>
+const typename PersistentBinarySearchTree<Key, Value>::Node * PersistentBinarySearchTree<Key, Value>::lowerBound( const NodePtr & root, const Key & key, std::size_t & index )
+{
+  const Node * bound = nullptr;
+  index = 0;
+
+  for( auto node = root.get();  node != nullptr; )
+  {
+    if( node->key_ < key )
+    {
+      index += size( node->left_ ) + 1;
+      node   = node->right_.get();
+    }
+    else
+    {
+      bound = node;
+      node  = node->left_.get();
+    }
+  }
+
+  return bound;
+}
+
+
+
+
+template <typename Key, typename Value>
+std::size_t PersistentBinarySearchTree<Key, Value>::size() const
+{ return size( current() ); }
+
+
+
+
+template <typename Key, typename Value>
+int PersistentBinarySearchTree<Key, Value>::getHeight() const
+{ return height( current() ); }
+
+
+
+
+template <typename Key, typename Value>
+void PersistentBinarySearchTree<Key, Value>::printInorder() const
+{
+  forEach( []( const Key & key, const Value & value ) { std::cout << "Key: \"" << key << "\",  Value: \"" << value << "\"\n"; } );
+}
+
+
+
+
+template <typename Key, typename Value>
+template <typename Visitor>
+void PersistentBinarySearchTree<Key, Value>::forEach( Visitor visit ) const
+{
+  auto root = current();
+  forEach( root.get(), visit );
+}
+
+
+
+
+template <typename Key, typename Value>
+template <typename Visitor>
+void PersistentBinarySearchTree<Key, Value>::forEach( const Node * node, Visitor & visit )
+{
+  if( node == nullptr ) return;
+
+  forEach( node->left_.get(), visit );
+  visit( node->key_, *node->value_ );
+  forEach( node->right_.get(), visit );
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Insert and remove
+////////////////////////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+void PersistentBinarySearchTree<Key, Value>::insert( const Key & key, const Value & value )
+{
+  auto newValue = std::make_shared<const Value>( value );
+
+  std::lock_guard<std::mutex> lock( writerMutex_ );
+  std::atomic_store( &root_, insert( root_, key, newValue ) );           // publish the new version with a single pointer store
+}
+
+
+
+
+template <typename Key, typename Value>
+typename PersistentBinarySearchTree<Key, Value>::NodePtr PersistentBinarySearchTree<Key, Value>::insert( const NodePtr & node, const Key & key, const std::shared_ptr<const Value> & value )
+{
+  if( node == nullptr ) return std::make_shared<const Node>( key, value, nullptr, nullptr );
+
+  if( key < node->key_ ) return balance( node->key_, node->value_, insert( node->left_, key, value ), node->right_ );
+  else                   return balance( node->key_, node->value_, node->left_, insert( node->right_, key, value ) );   // duplicates descend right
+}
+
+
+
+
+//  The first inserted match is found by position rather than by key, since equal keys may sit on either side of each other
+template <typename Key, typename Value>
+void PersistentBinarySearchTree<Key, Value>::remove( const Key & key )
+{
+  std::lock_guard<std::mutex> lock( writerMutex_ );
+
+  std::size_t index = 0;
+  auto node = lowerBound( root_, key, index );
+  if( node == nullptr  ||  !( node->key_ == key ) ) return;
+
+  std::atomic_store( &root_, removeAt( root_, index ) );
+}
+
+
+
+
+template <typename Key, typename Value>
+typename PersistentBinarySearchTree<Key, Value>::NodePtr PersistentBinarySearchTree<Key, Value>::removeAt( const NodePtr & node, std::size_t index )
+{
+  auto leftSize = size( node->left_ );
+
+  if( index < leftSize ) return balance( node->key_, node->value_, removeAt( node->left_,  index                ), node->right_ );
+  if( index > leftSize ) return balance( node->key_, node->value_, node->left_, removeAt( node->right_, index - leftSize - 1 ) );
+
+  // Found.  With two children, the successor's entry takes this node's place in a new node
+  if( node->left_  == nullptr ) return node->right_;
+  if( node->right_ == nullptr ) return node->left_;
+
+  NodePtr successor;
+  auto    right = removeFirst( node->right_, successor );
+  return balance( successor->key_, successor->value_, node->left_, right );
+}
+
+
+
+
+template <typename Key, typename Value>
+typename PersistentBinarySearchTree<Key, Value>::NodePtr PersistentBinarySearchTree<Key, Value>::removeFirst( const NodePtr & node, NodePtr & first )
+{
+  if( node->left_ == nullptr )
+  {
+    first = node;
+    return node->right_;
+  }
+
+  return balance( node->key_, node->value_, removeFirst( node->left_, first ), node->right_ );
+}
+
+
+
+
+//  Functional version of zyBook AVLTreeRebalance:  instead of rotating nodes in place, the nodes a rotation would change are built
+//  anew.  Inserting or removing one entry leaves the subtrees' heights at most 2 apart.
+template <typename Key, typename Value>
+typename PersistentBinarySearchTree<Key, Value>::NodePtr PersistentBinarySearchTree<Key, Value>::balance( const Key & key, const std::shared_ptr<const Value> & value, const NodePtr & left, const NodePtr & right )
+{
+  auto make = []( const Key & k, const std::shared_ptr<const Value> & v, const NodePtr & l, const NodePtr & r ) { return std::make_shared<const Node>( k, v, l, r ); };
+
+  if( height( left ) > height( right ) + 1 )                     // left heavy
+  {
+    if( height( left->left_ ) >= height( left->right_ ) )         // single right rotation
+    {
+      return make( left->key_, left->value_, left->left_, make( key, value, left->right_, right ) );
+    }
+
+    auto & middle = left->right_;                                 // left-right double rotation
+    return make( middle->key_, middle->value_, make( left->key_, left->value_, left->left_, middle->left_ ), make( key, value, middle->right_, right ) );
+  }
+
+  if( height( right ) > height( left ) + 1 )                     // right heavy
+  {
+    if( height( right->right_ ) >= height( right->left_ ) )
+    {
+      return make( right->key_, right->value_, make( key, value, left, right->left_ ), right->right_ );
+    }
+
+    auto & middle = right->left_;
+    return make( middle->key_, middle->value_, make( key, value, left, middle->left_ ), make( right->key_, right->value_, middle->right_, right->right_ ) );
+  }
+
+  return make( key, value, left, right );
+}
+
+
+
+
+template <typename Key, typename Value>
+int PersistentBinarySearchTree<Key, Value>::height( const NodePtr & node )
+{ return node == nullptr ? -1 : node->height_; }
+
+
+
+
+template <typename Key, typename Value>
+std::size_t PersistentBinarySearchTree<Key, Value>::size( const NodePtr & node )
+{ return node == nullptr ? 0 : node->size_; }
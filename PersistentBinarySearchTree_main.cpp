@@ -0,0 +1,84 @@
+#include <algorithm>  // shuffle()
+#include <atomic>
+#include <chrono>
+#include <cmath>      // log2()
+#include <iostream>
+#include <numeric>    // iota()
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PersistentBinarySearchTree.hpp"
+
+
+
+
+int main()
+{
+  PersistentBinarySearchTree<std::string, double> studentGrades;
+  studentGrades.insert( "Ricardo", 2.5  );
+  studentGrades.insert( "Ellen",   3.5  );
+  studentGrades.insert( "Chen",    2.5  );
+  studentGrades.insert( "Kevin",   3.25 );
+  studentGrades.insert( "Kumar",   3.05 );
+
+  auto firstTerm = studentGrades.snapshot();                            // O(1), shares every node
+
+  studentGrades.remove( "Ellen" );
+  studentGrades.insert( "Kumar", 3.6  );                                // duplicate, found after the first Kumar
+  studentGrades.insert( "Ellen", 3.75 );
+
+  if( firstTerm.size() != 5  ||  firstTerm.search( "Ellen" ) != 3.5 )                          std::cerr << "Snapshot changed after later updates\n";
+  if( studentGrades.size() != 6  ||  studentGrades.search( "Ellen" ) != 3.75 )                 std::cerr << "Persistent tree contents do not match expected\n";
+  if( studentGrades.search( "Kumar" ) != 3.05 )                                                 std::cerr << "Duplicate keys not found in insertion order\n";
+  studentGrades.remove( "Kumar" );
+  if( studentGrades.search( "Kumar" ) != 3.6  ||  firstTerm.search( "Kumar" ) != 3.05 )         std::cerr << "Removing a duplicate key did not remove the first inserted\n";
+
+  std::cout << "First term:\n";       firstTerm    .printInorder();
+  std::cout << "\nCurrent:\n";        studentGrades.printInorder();
+
+
+  // One writer keeps updating while a reader repeatedly snapshots the tree and checks every version it sees is internally consistent
+  constexpr unsigned N = 200'000;
+  std::vector<unsigned> keys( N );
+  std::iota   ( keys.begin(), keys.end(), 0U );
+  std::shuffle( keys.begin(), keys.end(), std::mt19937( 131 ) );
+
+  PersistentBinarySearchTree<unsigned, unsigned> tree;
+  std::atomic<bool> done     { false };
+  unsigned long     versions = 0;
+
+  std::thread reader( [&]
+  {
+    while( !done.load() )
+    {
+      auto          version  = tree.snapshot();
+      std::size_t   count    = 0;
+      unsigned long previous = 0;
+      bool          sorted   = true;
+
+      version.forEach( [&]( unsigned key, unsigned value ) { sorted = sorted  &&  key == value  &&  ( count == 0  ||  key > previous );  previous = key;  ++count; } );
+      if( !sorted  ||  count != version.size() ) std::cerr << "Snapshot read while writing is inconsistent\n";
+      ++versions;
+    }
+  } );
+
+  auto start = std::chrono::steady_clock::now();
+  for( auto key : keys )                        tree.insert( key, key );
+  for( unsigned i = 0;  i < N / 2;  ++i )       tree.remove( keys[i] );
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+  done = true;
+  reader.join();
+
+  if( tree.size() != N - N / 2  ||  tree.getHeight() > 1.45 * std::log2( N ) ) std::cerr << "Persistent tree size or height does not match expected\n";
+
+  std::cout << "\n" << N + N / 2 << " updates took " << elapsed.count() << " ms while a reader walked " << versions << " snapshots, height " << tree.getHeight() << '\n';
+}
+
+
+
+// Explicit instantiation - a technique to ensure all functions of the template are created and semantically checked.  By default,
+// only functions called get instantiated so you won't know it has compile errors until you actually call it.
+template class PersistentBinarySearchTree<unsigned, float>;
@@ -0,0 +1,593 @@
+#pragma once
+
+#include <algorithm>                                                      // move(), move_backward(), copy(), min(), max(), rotate(), remove_if()
+#include <cstddef>                                                        // size_t, ptrdiff_t
+#include <iterator>                                                       // iterator_traits, distance(), random_access_iterator_tag
+#include <memory>                                                         // allocator, uninitialized_copy(), destroy()
+#include <new>                                                            // placement new
+#include <stdexcept>                                                      // range_error
+#include <type_traits>                                                    // is_base_of
+#include <utility>                                                        // forward(), exchange()
+
+#include "ExtendableVector.hpp"
+
+
+
+
+// Template Class Definition
+//   Same interface as ExtendableVector, but elements are kept in fixed size chunks of ChunkSize elements found through a directory of
+//   chunk pointers.  Growing allocates one more chunk and never moves an element, so there's no O(n) pause as the vector grows and
+//   adding elements at the back never invalidates pointers or references to the others.  Indexing stays O(1), one extra indirection
+//   through the directory.  Inserting and erasing in the middle still shift the elements after them.
+template<typename T, std::size_t ChunkSize = 1024>
+class SegmentedVector
+{
+  static_assert( ChunkSize > 0  &&  ( ChunkSize & ( ChunkSize - 1 ) ) == 0, "ChunkSize must be a power of 2 so indexing needs no division" );
+
+  public:
+    class Iterator;                                                       // A random access iterator
+
+    // Constructors, destructor, and assignments
+    SegmentedVector            ( std::size_t capacity = ChunkSize );      // rounded up to whole chunks
+    SegmentedVector            ( const SegmentedVector & other );         // Copy constructor
+    SegmentedVector            (       SegmentedVector && other ) noexcept;   // Move constructor, takes over other's chunks leaving other empty
+    SegmentedVector & operator=( const SegmentedVector & rhs   );         // Copy assignment
+    SegmentedVector & operator=(       SegmentedVector && rhs  ) noexcept;    // Move assignment
+   ~SegmentedVector            ();
+
+    // Queries
+    T &          at        ( std::size_t index );                         // Checks bounds, throws std::range_error
+    T &          operator[]( std::size_t index );                         // No bounds checking
+
+    std::size_t size();
+    bool        empty();
+
+
+    // Iterators
+    Iterator begin();
+    Iterator end();
+
+
+    // Mutators
+    void push_back( const T & value );                                    // Checks capacity, throws std::range_error
+    void push_back(       T && value );                                   // Checks capacity, throws std::range_error
+    template <typename... Args>
+    T &  emplace_back( Args &&... args );                                 // Constructs the new element in place from args.  Checks capacity, throws std::range_error
+
+    std::size_t erase( std::size_t index    );                            // Checks bounds, throws std::range_error
+    Iterator    erase( Iterator    position );                            // Checks bounds, throws std::range_error
+    std::size_t erase( std::size_t first, std::size_t last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+    Iterator    erase( Iterator    first, Iterator    last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+
+    template <typename Predicate>
+    std::size_t erase_if( Predicate predicate );                          // Removes every element predicate( element ) is true for in a single pass.  Returns the number removed
+
+    void set( std::size_t index, const T & value );                       // Checks bounds, throws std::range_error
+    void set( std::size_t index,      T && value );                       // Checks bounds, throws std::range_error
+
+    std::size_t insert( std::size_t beforeIndex,    const T & value );    // Checks capacity, throws std::range_error
+    Iterator    insert( Iterator    beforePosition, const T & value );    // Checks capacity, throws std::range_error
+    std::size_t insert( std::size_t beforeIndex,         T && value );    // Checks capacity, throws std::range_error
+    Iterator    insert( Iterator    beforePosition,      T && value );    // Checks capacity, throws std::range_error
+
+    template <typename... Args>
+    std::size_t emplace( std::size_t beforeIndex,    Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+    template <typename... Args>
+    Iterator    emplace( Iterator    beforePosition, Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+
+    // Inserts copies of [first, last), which must not refer to this vector's elements, shifting the elements after them only once
+    template <typename InputIterator>
+    std::size_t insert( std::size_t beforeIndex,    InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    Iterator    insert( Iterator    beforePosition, InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    void        append( InputIterator first, InputIterator last );       // Checks capacity, throws std::range_error
+
+    void clear();
+
+
+  private:
+    std::size_t            _size = 0;                                     // number of elements in the data structure
+    ExtendableVector<T *>  _chunks{ 0 };                                  // directory of raw chunks, each ChunkSize elements long
+
+    T *         slot    ( std::size_t index );                            // address of the element (or raw storage) at index
+    std::size_t capacity();                                               // elements the allocated chunks can hold
+    void        reserve ( std::size_t newCapacity );                      // helper function to add chunks until newCapacity elements fit
+    void        release ();                                               // destroys the elements and returns every chunk
+};
+
+
+
+
+/*******************************************************************************
+**  SegmentedVector random access iterator.  Holds the vector and an index, so it stays valid as chunks are added
+*******************************************************************************/
+template<typename T, std::size_t ChunkSize>
+class SegmentedVector<T, ChunkSize>::Iterator
+{
+  friend class SegmentedVector<T, ChunkSize>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = T *;
+    using reference         = T &;
+
+    Iterator() = default;
+
+    T & operator* ()                           const;
+    T * operator->()                           const;
+    T & operator[]( difference_type offset )   const;
+
+    Iterator & operator++();                                              // advance to the next element   (pre -increment)
+    Iterator   operator++( int );                                         // advance to the next element   (post-increment)
+    Iterator & operator--();                                              // retreat to the previous element (pre -decrement)
+    Iterator   operator--( int );                                         // retreat to the previous element (post-decrement)
+
+    Iterator & operator+=( difference_type offset );
+    Iterator & operator-=( difference_type offset );
+    Iterator   operator+ ( difference_type offset ) const;
+    Iterator   operator- ( difference_type offset ) const;
+    difference_type operator-( const Iterator & rhs ) const;
+
+    bool operator==( const Iterator & rhs ) const;
+    bool operator!=( const Iterator & rhs ) const;
+    bool operator< ( const Iterator & rhs ) const;
+    bool operator<=( const Iterator & rhs ) const;
+    bool operator> ( const Iterator & rhs ) const;
+    bool operator>=( const Iterator & rhs ) const;
+
+  private:
+    Iterator( SegmentedVector * vector, std::size_t index );
+
+    SegmentedVector * _vector = nullptr;
+    std::size_t       _index  = 0;
+};
+
+
+
+
+
+
+// Implementation
+
+// Constructor with initial capacity argument
+template<typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector( std::size_t capacity )
+{ reserve( capacity ); }                                                  // storage only, no elements are constructed until added
+
+
+
+template <typename T, std::size_t ChunkSize>
+std::size_t SegmentedVector<T, ChunkSize>::size()
+{ return _size; }
+
+
+
+template <typename T, std::size_t ChunkSize>
+bool SegmentedVector<T, ChunkSize>::empty()
+{ return _size == 0; }
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::begin()
+{ return Iterator( this, 0 ); }
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::end()
+{ return Iterator( this, _size ); }
+
+
+
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::clear()
+{
+  // destroy the elements held allowing resources to be released.  But maintain "this" SegmentedVector's chunks
+  while( _size != 0 ) slot( --_size )->~T();                              // Direct call to destructor
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+T & SegmentedVector<T, ChunkSize>::at( std::size_t index )
+{
+  if( index >= _size ) throw std::range_error( "index out of bounds" );
+
+  return *slot( index );
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::push_back( const T & value )
+{ insert( _size, value ); }                                               // delegate to insert() leveraging error checking
+
+
+
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::push_back( T && value )
+{ insert( _size, std::move( value ) ); }                                  // delegate to insert() leveraging error checking
+
+
+
+template <typename T, std::size_t ChunkSize>
+template <typename... Args>
+T & SegmentedVector<T, ChunkSize>::emplace_back( Args &&... args )
+{ return *slot( emplace( _size, std::forward<Args>( args )... ) ); }      // delegate to emplace() leveraging error checking
+
+
+
+// Overloaded Array-Access Operator
+template <typename T, std::size_t ChunkSize>
+T & SegmentedVector<T, ChunkSize>::operator[]( std::size_t index )
+{ return *slot( index ); }                                                // Note: array bounds intentionally not checked
+
+
+
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::set( std::size_t index, const T & value )
+{ at( index ) = value; }                                                  // delegate to at() leveraging error checking
+
+
+
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::set( std::size_t index, T && value )
+{ at( index ) = std::move( value ); }                                     // delegate to at() leveraging error checking
+
+
+
+// Removes element from position. Elements from higher positions are shifted back to fill gap.
+// Vector size decrements
+template <typename T, std::size_t ChunkSize>
+std::size_t SegmentedVector<T, ChunkSize>::erase( std::size_t index )
+{
+  if( index >= _size ) throw std::range_error( "index out of bounds" );
+
+  // shift elements to the left and decrement the number of elements in the container
+  std::move( begin() + index + 1, end(), begin() + index );
+  slot( --_size )->~T();                                                  // the last slot now holds a moved-from element
+
+  return index;
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::erase( Iterator position )
+{
+  // delegate to delete by index
+  erase( position._index );
+  return position;
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+std::size_t SegmentedVector<T, ChunkSize>::erase( std::size_t first, std::size_t last )
+{
+  if( first > last  ||  last > _size ) throw std::range_error( "index out of bounds" );
+
+  // shift the elements after the range left once, then destroy the moved-from elements left at the end
+  std::move( begin() + last, end(), begin() + first );
+  while( last-- != first ) slot( --_size )->~T();
+
+  return first;
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::erase( Iterator first, Iterator last )
+{
+  // delegate to delete by index
+  erase( first._index, last._index );
+  return first;
+}
+
+
+
+// Keeps the elements predicate is false for in their original order, each moved at most once
+template <typename T, std::size_t ChunkSize>
+template <typename Predicate>
+std::size_t SegmentedVector<T, ChunkSize>::erase_if( Predicate predicate )
+{
+  auto kept    = std::remove_if( begin(), end(), predicate );
+  auto removed = static_cast<std::size_t>( end() - kept );
+
+  erase( kept, end() );
+  return removed;
+}
+
+
+
+// Copies x to element at position. Items at that position and higher are shifted over to make room. Vector size increments.
+template <typename T, std::size_t ChunkSize>
+std::size_t SegmentedVector<T, ChunkSize>::insert( std::size_t beforeIndex, const T & value )
+{ return emplace( beforeIndex, value ); }
+
+
+
+template <typename T, std::size_t ChunkSize>
+std::size_t SegmentedVector<T, ChunkSize>::insert( std::size_t beforeIndex, T && value )
+{ return emplace( beforeIndex, std::move( value ) ); }
+
+
+
+// Constructs a new element from args at position.  Items at that position and higher are shifted over to make room.  Vector size
+// increments.  A full vector grows by one chunk, no existing element moves
+template <typename T, std::size_t ChunkSize>
+template <typename... Args>
+std::size_t SegmentedVector<T, ChunkSize>::emplace( std::size_t beforeIndex, Args &&... args )
+{
+  if( beforeIndex > _size     ) beforeIndex = _size;                      // insert at the back
+  if( _size      == capacity() ) reserve( _size + 1 );                    // existing elements stay put, so args remain valid
+
+  if( beforeIndex == _size )
+  {
+    new( slot( _size ) ) T( std::forward<Args>( args )... );              // construct directly in the raw slot past the end
+    return _size++;
+  }
+
+  // args may refer to an element of this vector, so the new element is made before anything moves
+  T element( std::forward<Args>( args )... );
+
+  // The raw slot past the end is constructed from the last element, then the remaining elements move to create space starting from
+  // the right and working left
+  new( slot( _size ) ) T( std::move( *slot( _size - 1 ) ) );
+  std::move_backward( begin() + beforeIndex, end() - 1, end() );
+
+  *slot( beforeIndex ) = std::move( element );                            // move the new element into the vacated slot
+  ++_size;
+
+  return beforeIndex;
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::insert( Iterator beforePosition, const T & value )
+{ return begin() + insert( beforePosition._index, value ); }
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::insert( Iterator beforePosition, T && value )
+{ return begin() + insert( beforePosition._index, std::move( value ) ); }
+
+
+
+template <typename T, std::size_t ChunkSize>
+template <typename... Args>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::emplace( Iterator beforePosition, Args &&... args )
+{ return begin() + emplace( beforePosition._index, std::forward<Args>( args )... ); }
+
+
+
+// The new elements are appended in one pass, then a single rotation moves them into place shifting the elements after them
+template <typename T, std::size_t ChunkSize>
+template <typename InputIterator>
+std::size_t SegmentedVector<T, ChunkSize>::insert( std::size_t beforeIndex, InputIterator first, InputIterator last )
+{
+  if( beforeIndex > _size ) beforeIndex = _size;                          // insert at the back
+
+  auto oldSize = _size;
+  append( first, last );
+  std::rotate( begin() + beforeIndex, begin() + oldSize, end() );
+
+  return beforeIndex;
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+template <typename InputIterator>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::insert( Iterator beforePosition, InputIterator first, InputIterator last )
+{ return begin() + insert( beforePosition._index, first, last ); }
+
+
+
+// When the range can be measured up front, the chunks for all of it are added at once.  Otherwise elements are added one at a time.
+// Either way, if adding an element fails the elements already added are removed again
+template <typename T, std::size_t ChunkSize>
+template <typename InputIterator>
+void SegmentedVector<T, ChunkSize>::append( InputIterator first, InputIterator last )
+{
+  using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  if constexpr( std::is_base_of_v<std::forward_iterator_tag, Category> )
+  {
+    reserve( _size + static_cast<std::size_t>( std::distance( first, last ) ) );
+  }
+
+  auto oldSize = _size;
+  try
+  {
+    for( ;  first != last;  ++first ) emplace_back( *first );
+  }
+  catch( ... )
+  {
+    erase( oldSize, _size );
+    throw;
+  }
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+T * SegmentedVector<T, ChunkSize>::slot( std::size_t index )
+{ return _chunks[ index / ChunkSize ] + index % ChunkSize; }             // ChunkSize is a power of 2, so these are a shift and a mask
+
+
+
+template <typename T, std::size_t ChunkSize>
+std::size_t SegmentedVector<T, ChunkSize>::capacity()
+{ return _chunks.size() * ChunkSize; }
+
+
+
+// Only the directory of chunk pointers is ever relocated, and it holds one pointer per ChunkSize elements
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::reserve( std::size_t newCapacity )
+{
+  while( capacity() < newCapacity ) _chunks.push_back( std::allocator<T>().allocate( ChunkSize ) );
+}
+
+
+
+template <typename T, std::size_t ChunkSize>
+void SegmentedVector<T, ChunkSize>::release()
+{
+  clear();
+  for( auto chunk : _chunks ) std::allocator<T>().deallocate( chunk, ChunkSize );
+  _chunks.clear();
+}
+
+
+
+// Copy Constructor
+template <typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector( const SegmentedVector<T, ChunkSize> & other )
+: SegmentedVector( other._size )
+{
+  // Copy each element from the other vector to this vector.  Once the delegated constructor has finished, the destructor releases
+  // the chunks if a copy throws
+  for( std::size_t index = 0;  index < other._size;  ++index )
+  {
+    new( slot( index ) ) T( *const_cast<SegmentedVector &>( other ).slot( index ) );
+    ++_size;
+  }
+}
+
+
+
+// Overloaded Assignment Operator
+template<typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize> & SegmentedVector<T, ChunkSize>::operator=( const SegmentedVector<T, ChunkSize> & rhs )
+{
+  if( this != &rhs )
+  {
+    auto & source = const_cast<SegmentedVector &>( rhs );                 // only read, slot() just isn't const
+    reserve( source._size );
+
+    // Assign over the live elements, copy construct into raw storage past them, and destroy any left over
+    auto overlap = std::min( _size, source._size );
+    std::copy( source.begin(), source.begin() + overlap, begin() );
+    if( _size > source._size ) erase( source._size, _size );
+
+    while( _size < source._size )
+    {
+      new( slot( _size ) ) T( *source.slot( _size ) );
+      ++_size;
+    }
+  }
+
+  return *this;
+}
+
+
+
+// Move Constructor
+template <typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::SegmentedVector( SegmentedVector<T, ChunkSize> && other ) noexcept
+: _size  ( std::exchange( other._size, 0 ) ),
+  _chunks( std::move( other._chunks ) )
+{}                                                                        // other keeps no chunks at all, nothing is copied
+
+
+
+// Move Assignment Operator
+template<typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize> & SegmentedVector<T, ChunkSize>::operator=( SegmentedVector<T, ChunkSize> && rhs ) noexcept
+{
+  if( this != &rhs )
+  {
+    release();
+
+    _size   = std::exchange( rhs._size, 0 );
+    _chunks = std::move( rhs._chunks );
+  }
+
+  return *this;
+}
+
+
+
+// Destructor
+template <typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::~SegmentedVector()
+{ release(); }
+
+
+
+
+
+
+
+
+
+/*******************************************************************************
+**  SegmentedVector<T, ChunkSize>::Iterator  Definitions
+*******************************************************************************/
+template <typename T, std::size_t ChunkSize>
+SegmentedVector<T, ChunkSize>::Iterator::Iterator( SegmentedVector * vector, std::size_t index )
+  : _vector( vector ), _index( index )
+{}
+
+
+
+template <typename T, std::size_t ChunkSize>  T & SegmentedVector<T, ChunkSize>::Iterator::operator* ()                         const { return *_vector->slot( _index ); }
+template <typename T, std::size_t ChunkSize>  T * SegmentedVector<T, ChunkSize>::Iterator::operator->()                         const { return  _vector->slot( _index ); }
+template <typename T, std::size_t ChunkSize>  T & SegmentedVector<T, ChunkSize>::Iterator::operator[]( difference_type offset ) const { return *_vector->slot( _index + offset ); }
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator & SegmentedVector<T, ChunkSize>::Iterator::operator++()
+{ ++_index;  return *this; }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::Iterator::operator++( int )
+{ auto temp = *this;  ++_index;  return temp; }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator & SegmentedVector<T, ChunkSize>::Iterator::operator--()
+{ --_index;  return *this; }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::Iterator::operator--( int )
+{ auto temp = *this;  --_index;  return temp; }
+
+
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator & SegmentedVector<T, ChunkSize>::Iterator::operator+=( difference_type offset )
+{ _index += offset;  return *this; }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator & SegmentedVector<T, ChunkSize>::Iterator::operator-=( difference_type offset )
+{ _index -= offset;  return *this; }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::Iterator::operator+( difference_type offset ) const
+{ return Iterator( _vector, _index + offset ); }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator SegmentedVector<T, ChunkSize>::Iterator::operator-( difference_type offset ) const
+{ return Iterator( _vector, _index - offset ); }
+
+template <typename T, std::size_t ChunkSize>
+typename SegmentedVector<T, ChunkSize>::Iterator::difference_type SegmentedVector<T, ChunkSize>::Iterator::operator-( const Iterator & rhs ) const
+{ return static_cast<difference_type>( _index ) - static_cast<difference_type>( rhs._index ); }
+
+
+
+template <typename T, std::size_t ChunkSize>  bool SegmentedVector<T, ChunkSize>::Iterator::operator==( const Iterator & rhs ) const { return _index == rhs._index; }
+template <typename T, std::size_t ChunkSize>  bool SegmentedVector<T, ChunkSize>::Iterator::operator!=( const Iterator & rhs ) const { return _index != rhs._index; }
+template <typename T, std::size_t ChunkSize>  bool SegmentedVector<T, ChunkSize>::Iterator::operator< ( const Iterator & rhs ) const { return _index <  rhs._index; }
+template <typename T, std::size_t ChunkSize>  bool SegmentedVector<T, ChunkSize>::Iterator::operator<=( const Iterator & rhs ) const { return _index <= rhs._index; }
+template <typename T, std::size_t ChunkSize>  bool SegmentedVector<T, ChunkSize>::Iterator::operator> ( const Iterator & rhs ) const { return _index >  rhs._index; }
+template <typename T, std::size_t ChunkSize>  bool SegmentedVector<T, ChunkSize>::Iterator::operator>=( const Iterator & rhs ) const { return _index >= rhs._index; }
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <algorithm>                                                      // move(), move_backward(), copy(), min(), max(), rotate(), remove_if()
+#include <cstddef>                                                        // size_t
+#include <iterator>                                                       // iterator_traits, distance()
+#include <memory>                                                         // allocator, uninitialized_copy_n(), uninitialized_copy(), uninitialized_move(), destroy()
+#include <new>                                                            // placement new
+#include <stdexcept>                                                      // range_error
+#include <type_traits>                                                    // is_nothrow_move_constructible, is_base_of
+#include <utility>                                                        // forward(), exchange()
+
+
+
+
+// Template Class Definition
+//   Same interface as ExtendableVector, but the first InlineCapacity elements are kept inside the vector object itself.  A vector that
+//   never holds more than InlineCapacity elements never allocates, and only spills to the heap (doubling as it grows) on overflow.
+//   Moving a vector whose elements are inline moves them one by one, so pointers into it do not survive a move.
+template<typename T, std::size_t InlineCapacity = 8>
+class SmallVector
+{
+  static_assert( InlineCapacity > 0, "Use ExtendableVector when no elements are to be kept inline" );
+
+  public:
+    // Constructors, destructor, and assignments
+    SmallVector            ( std::size_t capacity = InlineCapacity );     // capacity beyond InlineCapacity is allocated up front
+    SmallVector            ( const SmallVector & other );                 // Copy constructor
+    SmallVector            (       SmallVector && other ) noexcept( std::is_nothrow_move_constructible_v<T> );   // Move constructor, leaves other empty
+    SmallVector & operator=( const SmallVector & rhs   );                 // Copy assignment
+    SmallVector & operator=(       SmallVector && rhs  ) noexcept( std::is_nothrow_move_constructible_v<T> );   // Move assignment
+   ~SmallVector            ();
+
+    // Queries
+    T &          at        ( std::size_t index );                         // Checks bounds, throws std::range_error
+    T &          operator[]( std::size_t index );                         // No bounds checking
+
+    std::size_t size();
+    bool        empty();
+    bool        isInline();                                               // True while the elements are kept inside the vector object
+
+
+    // Iterators
+    T * begin();
+    T * end();
+
+
+    // Mutators
+    void push_back( const T & value );                                    // Checks capacity, throws std::range_error
+    void push_back(       T && value );                                   // Checks capacity, throws std::range_error
+    template <typename... Args>
+    T &  emplace_back( Args &&... args );                                 // Constructs the new element in place from args.  Checks capacity, throws std::range_error
+
+    std::size_t erase( std::size_t index    );                            // Checks bounds, throws std::range_error
+    T *         erase( T *         position );                            // Checks bounds, throws std::range_error
+    std::size_t erase( std::size_t first, std::size_t last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+    T *         erase( T *         first, T *         last );             // Removes [first, last) with a single shift.  Checks bounds, throws std::range_error
+
+    template <typename Predicate>
+    std::size_t erase_if( Predicate predicate );                          // Removes every element predicate( element ) is true for in a single pass.  Returns the number removed
+
+    void set( std::size_t index, const T & value );                       // Checks bounds, throws std::range_error
+    void set( std::size_t index,      T && value );                       // Checks bounds, throws std::range_error
+
+    std::size_t insert( std::size_t beforeIndex,    const T & value );    // Checks capacity, throws std::range_error
+    T *         insert( T *         beforePosition, const T & value );    // Checks capacity, throws std::range_error
+    std::size_t insert( std::size_t beforeIndex,         T && value );    // Checks capacity, throws std::range_error
+    T *         insert( T *         beforePosition,      T && value );    // Checks capacity, throws std::range_error
+
+    template <typename... Args>
+    std::size_t emplace( std::size_t beforeIndex,    Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+    template <typename... Args>
+    T *         emplace( T *         beforePosition, Args &&... args );  // Constructs the new element from args.  Checks capacity, throws std::range_error
+
+    // Inserts copies of [first, last), which must not refer to this vector's elements, shifting the elements after them only once
+    template <typename InputIterator>
+    std::size_t insert( std::size_t beforeIndex,    InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    T *         insert( T *         beforePosition, InputIterator first, InputIterator last );  // Checks capacity, throws std::range_error
+    template <typename InputIterator>
+    void        append( InputIterator first, InputIterator last );       // Checks capacity, throws std::range_error
+
+    void clear();
+
+
+  private:
+    alignas( T ) unsigned char _inline[ InlineCapacity * sizeof( T ) ];   // raw storage for the first InlineCapacity elements
+
+    std::size_t _size     = 0;                                            // number of elements in the data structure
+    std::size_t _capacity = InlineCapacity;                               // length of the array
+    T *         _array    = reinterpret_cast<T *>( _inline );             // _inline until the first spill, then a dynamically allocated array
+
+    void reserve ( size_t newCapacity );                                  // helper function to change capacity
+    void release ();                                                      // returns a heap array, if any, and points _array back at _inline
+    void takeOver( SmallVector && other );                                // moves other's elements into this empty vector, leaving other empty
+};
+
+
+
+
+
+
+// Implementation
+
+// Constructor with initial capacity argument
+template<typename T, std::size_t InlineCapacity>
+SmallVector<T, InlineCapacity>::SmallVector( std::size_t capacity )
+{ reserve( capacity ); }                                                  // storage only, no elements are constructed until added
+
+
+
+template <typename T, std::size_t InlineCapacity>
+std::size_t SmallVector<T, InlineCapacity>::size()
+{ return _size; }
+
+
+
+template <typename T, std::size_t InlineCapacity>
+bool SmallVector<T, InlineCapacity>::empty()
+{ return _size == 0; }
+
+
+
+template <typename T, std::size_t InlineCapacity>
+bool SmallVector<T, InlineCapacity>::isInline()
+{ return _array == reinterpret_cast<T *>( _inline ); }
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T * SmallVector<T, InlineCapacity>::begin()
+{ return _array; }
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T * SmallVector<T, InlineCapacity>::end()
+{ return _array + _size; }                                                // Note the pointer arithmetic used
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::clear()
+{
+  // destroy the elements held allowing resources to be released.  But maintain "this" SmallVector's capacity
+  while( _size != 0 ) _array[--_size].~T();                               // Direct call to destructor
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T & SmallVector<T, InlineCapacity>::at( std::size_t index )
+{
+  if( index >= _size ) throw std::range_error( "index out of bounds" );
+
+  return _array[ index ];
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::push_back( const T & value )
+{ insert( _size, value ); }                                               // delegate to insert() leveraging error checking
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::push_back( T && value )
+{ insert( _size, std::move( value ) ); }                                  // delegate to insert() leveraging error checking
+
+
+
+template <typename T, std::size_t InlineCapacity>
+template <typename... Args>
+T & SmallVector<T, InlineCapacity>::emplace_back( Args &&... args )
+{ return _array[ emplace( _size, std::forward<Args>( args )... ) ]; }     // delegate to emplace() leveraging error checking
+
+
+
+// Overloaded Array-Access Operator
+template <typename T, std::size_t InlineCapacity>
+T & SmallVector<T, InlineCapacity>::operator[]( std::size_t index )
+{ return _array[ index ]; }                                               // Note: array bounds intentionally not checked
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::set( std::size_t index, const T & value )
+{ at( index ) = value; }                                                  // delegate to at() leveraging error checking
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::set( std::size_t index, T && value )
+{ at( index ) = std::move( value ); }                                     // delegate to at() leveraging error checking
+
+
+
+// Removes element from position. Elements from higher positions are shifted back to fill gap.
+// Vector size decrements
+template <typename T, std::size_t InlineCapacity>
+std::size_t SmallVector<T, InlineCapacity>::erase( std::size_t index )
+{
+  if( index >= _size ) throw std::range_error( "index out of bounds" );
+
+  // shift elements to the left and decrement the number of elements in the container
+  std::move( _array + index + 1, _array + _size, _array + index );        // Note the pointer arithmetic here
+  _array[--_size].~T();                                                   // the last slot now holds a moved-from element
+
+  return index;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T * SmallVector<T, InlineCapacity>::erase( T * position )
+{
+  // delegate to delete by index
+  auto index = position - begin();                                        // Note the pointer arithmetic here
+  erase( index );
+  return position;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+std::size_t SmallVector<T, InlineCapacity>::erase( std::size_t first, std::size_t last )
+{
+  if( first > last  ||  last > _size ) throw std::range_error( "index out of bounds" );
+
+  // shift the elements after the range left once, then destroy the moved-from elements left at the end
+  std::move( _array + last, _array + _size, _array + first );             // Note the pointer arithmetic here
+  std::destroy( _array + _size - ( last - first ), _array + _size );
+  _size -= last - first;
+
+  return first;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T * SmallVector<T, InlineCapacity>::erase( T * first, T * last )
+{
+  // delegate to delete by index
+  erase( first - begin(), last - begin() );                               // Note the pointer arithmetic here
+  return first;
+}
+
+
+
+// Keeps the elements predicate is false for in their original order, each moved at most once
+template <typename T, std::size_t InlineCapacity>
+template <typename Predicate>
+std::size_t SmallVector<T, InlineCapacity>::erase_if( Predicate predicate )
+{
+  auto kept    = std::remove_if( begin(), end(), predicate );
+  auto removed = static_cast<std::size_t>( end() - kept );
+
+  std::destroy( kept, end() );
+  _size -= removed;
+
+  return removed;
+}
+
+
+
+// Copies x to element at position. Items at that position and higher are shifted over to make room. Vector size increments.
+template <typename T, std::size_t InlineCapacity>
+std::size_t SmallVector<T, InlineCapacity>::insert( std::size_t beforeIndex, const T & value )
+{ return emplace( beforeIndex, value ); }
+
+
+
+template <typename T, std::size_t InlineCapacity>
+std::size_t SmallVector<T, InlineCapacity>::insert( std::size_t beforeIndex, T && value )
+{ return emplace( beforeIndex, std::move( value ) ); }
+
+
+
+// Constructs a new element from args at position.  Items at that position and higher are shifted over to make room.  Vector size
+// increments.
+template <typename T, std::size_t InlineCapacity>
+template <typename... Args>
+std::size_t SmallVector<T, InlineCapacity>::emplace( std::size_t beforeIndex, Args &&... args )
+{
+  if( beforeIndex > _size ) beforeIndex = _size;                          // insert at the back
+
+  if( beforeIndex == _size  &&  _size < _capacity )
+  {
+    new( _array + _size ) T( std::forward<Args>( args )... );             // construct directly in the raw slot past the end
+    return _size++;
+  }
+
+  // args may refer to an element of this vector, so the new element is made before anything moves
+  T element( std::forward<Args>( args )... );
+  if( _size >= _capacity ) reserve( 2 * _capacity );                      // If at max capacity, spill to the heap (or double the heap array)
+
+  if( beforeIndex == _size )
+  {
+    new( _array + _size ) T( std::move( element ) );
+  }
+  else
+  {
+    // The raw slot past the end is constructed from the last element, then the remaining elements move to create space starting from
+    // the right and working left
+    new( _array + _size ) T( std::move( _array[ _size - 1 ] ) );
+    std::move_backward( _array + beforeIndex, _array + _size - 1, _array + _size );   // Note the pointer arithmetic here
+
+    _array[ beforeIndex ] = std::move( element );                         // move the new element into the vacated slot
+  }
+  ++_size;
+
+  return beforeIndex;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T* SmallVector<T, InlineCapacity>::insert( T * beforePosition, const T & value )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, value );
+  return begin() + index;                                                 // the array may have moved
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+T* SmallVector<T, InlineCapacity>::insert( T * beforePosition, T && value )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, std::move( value ) );
+  return begin() + index;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+template <typename... Args>
+T* SmallVector<T, InlineCapacity>::emplace( T * beforePosition, Args &&... args )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  emplace( index, std::forward<Args>( args )... );
+  return begin() + index;
+}
+
+
+
+// The new elements are appended in one pass, then a single rotation moves them into place shifting the elements after them
+template <typename T, std::size_t InlineCapacity>
+template <typename InputIterator>
+std::size_t SmallVector<T, InlineCapacity>::insert( std::size_t beforeIndex, InputIterator first, InputIterator last )
+{
+  if( beforeIndex > _size ) beforeIndex = _size;                          // insert at the back
+
+  auto oldSize = _size;
+  append( first, last );
+  std::rotate( _array + beforeIndex, _array + oldSize, _array + _size );  // Note the pointer arithmetic here
+
+  return beforeIndex;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+template <typename InputIterator>
+T* SmallVector<T, InlineCapacity>::insert( T * beforePosition, InputIterator first, InputIterator last )
+{
+  auto index = beforePosition - begin();                                  // Note the pointer arithmetic here
+  insert( index, first, last );
+  return begin() + index;                                                 // the array may have moved
+}
+
+
+
+// When the range can be measured up front, room for all of it is made at once.  Otherwise elements are added one at a time.  Either
+// way, if adding an element fails the elements already added are removed again
+template <typename T, std::size_t InlineCapacity>
+template <typename InputIterator>
+void SmallVector<T, InlineCapacity>::append( InputIterator first, InputIterator last )
+{
+  using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+  if constexpr( std::is_base_of_v<std::forward_iterator_tag, Category> )
+  {
+    auto count = static_cast<std::size_t>( std::distance( first, last ) );
+    if( _size + count > _capacity ) reserve( std::max( _size + count, 2 * _capacity ) );   // at most one reallocation
+
+    std::uninitialized_copy( first, last, _array + _size );              // destroys the copies already made if one throws
+    _size += count;
+  }
+  else
+  {
+    auto oldSize = _size;
+    try
+    {
+      for( ;  first != last;  ++first ) emplace_back( *first );
+    }
+    catch( ... )
+    {
+      std::destroy( _array + oldSize, _array + _size );
+      _size = oldSize;
+      throw;
+    }
+  }
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::reserve( std::size_t newCapacity )
+{
+  if( newCapacity <= _capacity ) return;
+
+  T * newArray = std::allocator<T>().allocate( newCapacity );
+  // Move construct values into the new array's raw storage, then destroy the moved-from originals
+  try
+  {
+    std::uninitialized_move( _array, _array + _size, newArray );
+  }
+  catch( ... )
+  {
+    std::allocator<T>().deallocate( newArray, newCapacity );
+    throw;
+  }
+
+  std::destroy( _array, _array + _size );
+  release();
+  _array    = newArray;
+  _capacity = newCapacity;
+}
+
+
+
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::release()
+{
+  if( !isInline() ) std::allocator<T>().deallocate( _array, _capacity );
+
+  _array    = reinterpret_cast<T *>( _inline );
+  _capacity = InlineCapacity;
+}
+
+
+
+// Inline elements have to be moved one by one, but a heap array is simply taken over
+template <typename T, std::size_t InlineCapacity>
+void SmallVector<T, InlineCapacity>::takeOver( SmallVector<T, InlineCapacity> && other )
+{
+  if( other.isInline() )
+  {
+    std::uninitialized_move( other._array, other._array + other._size, _array );
+    _size = other._size;
+    other.clear();
+  }
+  else
+  {
+    _size     = std::exchange( other._size,     0     );
+    _capacity = std::exchange( other._capacity, InlineCapacity );
+    _array    = std::exchange( other._array,    reinterpret_cast<T *>( other._inline ) );
+  }
+}
+
+
+
+// Copy Constructor
+template <typename T, std::size_t InlineCapacity>
+SmallVector<T, InlineCapacity>::SmallVector( const SmallVector<T, InlineCapacity> & other )
+: SmallVector( other._size )
+{
+  // Copy construct each element from the other vector into this vector's raw storage.  Once the delegated constructor has finished,
+  // the destructor releases any heap array if a copy throws
+  std::uninitialized_copy_n( other._array, other._size, _array );
+  _size = other._size;
+}
+
+
+
+// Overloaded Assignment Operator
+template<typename T, std::size_t InlineCapacity>
+SmallVector<T, InlineCapacity> & SmallVector<T, InlineCapacity>::operator=( const SmallVector<T, InlineCapacity> & rhs )
+{
+  if( this != &rhs )
+  {
+    // Can the stuff in the right hand side (rhs) fit into this vector? If not, expand this vector's capacity.  Clearing first means
+    // nothing is moved just to be overwritten
+    if( rhs._size > _capacity )
+    {
+      clear();
+      reserve( rhs._size );
+    }
+
+    // Assign over the live elements, copy construct into raw storage past them, and destroy any left over
+    auto overlap = std::min( _size, rhs._size );
+    std::copy( rhs._array, rhs._array + overlap, _array );
+    std::uninitialized_copy( rhs._array + overlap, rhs._array + rhs._size, _array + overlap );
+    std::destroy( _array + rhs._size, _array + std::max( _size, rhs._size ) );
+    _size = rhs._size;
+  }
+
+  return *this;
+}
+
+
+
+// Move Constructor
+template <typename T, std::size_t InlineCapacity>
+SmallVector<T, InlineCapacity>::SmallVector( SmallVector<T, InlineCapacity> && other ) noexcept( std::is_nothrow_move_constructible_v<T> )
+{ takeOver( std::move( other ) ); }
+
+
+
+// Move Assignment Operator
+template<typename T, std::size_t InlineCapacity>
+SmallVector<T, InlineCapacity> & SmallVector<T, InlineCapacity>::operator=( SmallVector<T, InlineCapacity> && rhs ) noexcept( std::is_nothrow_move_constructible_v<T> )
+{
+  if( this != &rhs )
+  {
+    clear();
+    release();
+    takeOver( std::move( rhs ) );
+  }
+
+  return *this;
+}
+
+
+
+// Destructor
+template <typename T, std::size_t InlineCapacity>
+SmallVector<T, InlineCapacity>::~SmallVector()
+{
+  clear();                                                                // only live elements are destroyed, the rest of the storage is raw
+  release();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>                                                      // min()
+#include <cstdint>                                                        // uint64_t
+#include <iostream>
+#include <limits>                                                         // numeric_limits
+#include <stdexcept>                                                      // runtime_error
+#include <string>
+#include <type_traits>                                                    // is_trivially_copyable
+
+
+
+
+/*******************************************************************************
+** Binary snapshot encoding of a single object
+**
+** Containers that save themselves to a binary snapshot (see BinarySearchTree::save() and load()) encode every element through
+** SnapshotIO<T>.  Trivially copyable types are written as their raw bytes, so a snapshot is only meant to be read back on the same
+** platform by the same build.  Other types provide a specialization with the same two static functions, see SnapshotIO<std::string>
+** below and SnapshotIO<Student> for examples.
+**
+** read() throws runtime_error if the stream ends early or fails.  Counts and lengths read from a snapshot can't be trusted until what
+** they count has been read, so nothing is allocated for them beyond what the stream can still hold (see snapshotBytesLeft()).
+*******************************************************************************/
+template <typename T>
+struct SnapshotIO
+{
+  static_assert( std::is_trivially_copyable_v<T>, "Types with pointers or resources must specialize SnapshotIO" );
+
+  static void write( std::ostream & stream, const T & object );
+  static void read ( std::istream & stream,       T & object );
+};
+
+
+
+template <>
+struct SnapshotIO<std::string>                                            // length followed by the characters
+{
+  static void write( std::ostream & stream, const std::string & object );
+  static void read ( std::istream & stream,       std::string & object );
+};
+
+
+
+// The number of bytes left to read in stream, or the largest uint64_t if the stream can't tell, as for a pipe
+std::uint64_t snapshotBytesLeft( std::istream & stream );
+
+
+
+
+
+
+// Implementation
+
+template <typename T>
+void SnapshotIO<T>::write( std::ostream & stream, const T & object )
+{ stream.write( reinterpret_cast<const char *>( &object ), sizeof( T ) ); }
+
+
+
+template <typename T>
+void SnapshotIO<T>::read( std::istream & stream, T & object )
+{
+  if( !stream.read( reinterpret_cast<char *>( &object ), sizeof( T ) ) ) throw std::runtime_error( "Snapshot truncated or unreadable" );
+}
+
+
+
+inline void SnapshotIO<std::string>::write( std::ostream & stream, const std::string & object )
+{
+  SnapshotIO<std::uint64_t>::write( stream, object.size() );
+  stream.write( object.data(), static_cast<std::streamsize>( object.size() ) );
+}
+
+
+
+inline void SnapshotIO<std::string>::read( std::istream & stream, std::string & object )
+{
+  std::uint64_t length = 0;
+  SnapshotIO<std::uint64_t>::read( stream, length );
+
+  // Read a chunk at a time so a corrupt length fails once the stream runs out, rather than first trying to allocate all of it
+  constexpr std::uint64_t CHUNK = 1 << 16;
+
+  object.clear();
+  while( object.size() < length )
+  {
+    std::uint64_t done = object.size();
+    std::uint64_t more = std::min( CHUNK, length - done );
+    object.resize( done + more );
+    if( !stream.read( object.data() + done, static_cast<std::streamsize>( more ) ) ) throw std::runtime_error( "Snapshot truncated or unreadable" );
+  }
+}
+
+
+
+// Seeks to the end and back, so it's meant to be called once per container rather than once per element
+inline std::uint64_t snapshotBytesLeft( std::istream & stream )
+{
+  constexpr auto UNKNOWN = std::numeric_limits<std::uint64_t>::max();
+
+  auto here = stream.tellg();
+  if( here == std::streampos( -1 ) ) return UNKNOWN;
+
+  stream.seekg( 0, std::ios::end );
+  auto end = stream.tellg();
+  stream.seekg( here );
+
+  return end == std::streampos( -1 ) ? UNKNOWN : static_cast<std::uint64_t>( end - here );
+}
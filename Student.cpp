@@ -1,6 +1,7 @@
 #include <iomanip>    // quoted()
 #include <iostream>
 #include <string>
+#include <utility>    // move()
 
 #include "Student.hpp"
 
@@ -25,6 +26,11 @@ Student::Student( std::string name, unsigned nsem )
 /******************************************************************************
 ** Queries
 ******************************************************************************/
+const std::string & Student::name() const
+{ return _name; }
+
+unsigned Student::semesters() const
+{ return _numOfSemesters; }
 
 
 
@@ -101,3 +107,24 @@ std::istream & operator>>( std::istream & is, Student & student )
 
   return is;
 }
+
+
+
+/******************************************************************************
+** Binary Snapshot Encoding
+******************************************************************************/
+void SnapshotIO<Student>::write( std::ostream & stream, const Student & student )
+{
+  SnapshotIO<std::string>::write( stream, student.name()      );
+  SnapshotIO<unsigned   >::write( stream, student.semesters() );
+}
+
+void SnapshotIO<Student>::read( std::istream & stream, Student & student )
+{
+  std::string name;
+  unsigned    semesters = 0;
+  SnapshotIO<std::string>::read( stream, name      );
+  SnapshotIO<unsigned   >::read( stream, semesters );
+
+  student = Student( std::move( name ), semesters );
+}
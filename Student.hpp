@@ -3,6 +3,8 @@
 #include <iostream>
 #include <string>
 
+#include "SnapshotIO.hpp"
+
 
 
 
@@ -18,6 +20,9 @@ class Student
     Student();
     Student( std::string name, unsigned nsem = 1U );
 
+    const std::string & name     () const;
+    unsigned            semesters() const;
+
     void updateNSemesters();
     void name            ( const std::string & name      );
     void semesters       ( unsigned            semesters );
@@ -32,3 +37,14 @@ bool operator!=( const Student & lhs, const Student & rhs );
 bool operator<=( const Student & lhs, const Student & rhs );
 bool operator> ( const Student & lhs, const Student & rhs );
 bool operator>=( const Student & lhs, const Student & rhs );
+
+
+
+
+// Lets containers of Students be saved to and loaded from binary snapshots
+template <>
+struct SnapshotIO<Student>
+{
+  static void write( std::ostream & stream, const Student & student );
+  static void read ( std::istream & stream,       Student & student );
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>                                                      // min()
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>                                                        // size_t
+#include <exception>                                                      // exception_ptr
+#include <functional>                                                     // function
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+
+/*******************************************************************************
+** A fixed set of worker threads that cooperatively run data parallel jobs
+**
+** parallelFor( count, task ) calls task(0) through task(count-1), each exactly once, spread across the workers and the calling thread,
+** and returns when all have finished.  Workers are started once and sleep between jobs, so a job costs a wake up rather than thread
+** creation.  Tasks are handed out one index at a time, so uneven tasks still keep every thread busy.
+**
+** One job runs at a time, other callers wait their turn.  A task that itself calls parallelFor runs that inner job serially on its
+** own thread rather than waiting for workers that are busy running the outer job.  The first exception thrown by a task is rethrown
+** to the caller after the job finishes.
+*******************************************************************************/
+class TaskPool
+{
+  public:
+    // Constructors, destructor, and assignments
+    TaskPool            ( std::size_t nThreads = std::thread::hardware_concurrency() );   // total threads, including the calling thread
+    TaskPool            ( const TaskPool & ) = delete;
+    TaskPool & operator=( const TaskPool & ) = delete;
+   ~TaskPool            ();
+
+    static TaskPool & instance();                                         // A pool shared by the whole program, sized to the hardware
+
+    // Queries
+    std::size_t concurrency() const;                                      // Number of threads, including the caller, a job will use
+
+    // Mutators
+    void setConcurrency( std::size_t nThreads );                          // Limits jobs to nThreads (at least 1, at most the pool's size)
+
+    template <typename Task>
+    void parallelFor( std::size_t count, Task && task );                  // Runs task(i) for every i in [0, count) and waits for all to finish
+
+
+  private:
+    std::vector<std::thread>              _workers;
+    std::atomic<std::size_t>              _concurrency;
+
+    std::mutex                            _jobMutex;                      // one job at a time
+    std::mutex                            _mutex;                         // protects everything below
+    std::condition_variable               _wakeUp;
+    std::condition_variable               _finished;
+
+    std::function<void( std::size_t )>    _task;                          // the current job
+    std::size_t                           _count      = 0;
+    std::atomic<std::size_t>              _next       { 0 };              // next index to hand out
+    std::size_t                           _generation = 0;                // incremented for every job, tells sleeping workers there's work
+    std::size_t                           _joined     = 0;                // workers still allowed to join the current job
+    std::size_t                           _busy       = 0;                // workers currently running the current job
+    std::exception_ptr                    _error;
+    bool                                  _stopping   = false;
+
+    void workerLoop();
+    void runTasks  ();                                                    // Runs tasks of the current job until none are left
+
+    static bool & insideTask();                                           // True on a thread currently running a task
+};
+
+
+
+
+
+
+// Implementation
+
+inline TaskPool::TaskPool( std::size_t nThreads )
+  : _concurrency( std::max<std::size_t>( nThreads, 1 ) )
+{
+  for( std::size_t i = 1;  i < _concurrency;  ++i ) _workers.emplace_back( [this] { workerLoop(); } );
+}
+
+
+
+inline TaskPool::~TaskPool()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _stopping = true;
+  }
+  _wakeUp.notify_all();
+
+  for( auto & worker : _workers ) worker.join();
+}
+
+
+
+inline TaskPool & TaskPool::instance()
+{
+  static TaskPool pool;                                                   // thread safe initialization on first use
+  return pool;
+}
+
+
+
+inline std::size_t TaskPool::concurrency() const
+{ return _concurrency; }
+
+
+
+inline void TaskPool::setConcurrency( std::size_t nThreads )
+{ _concurrency = std::min( std::max<std::size_t>( nThreads, 1 ), _workers.size() + 1 ); }
+
+
+
+template <typename Task>
+void TaskPool::parallelFor( std::size_t count, Task && task )
+{
+  if( count == 0 ) return;
+
+  if( count == 1  ||  _concurrency == 1  ||  insideTask() )             // nothing to gain, or nested inside another job
+  {
+    for( std::size_t i = 0;  i < count;  ++i ) task( i );
+    return;
+  }
+
+  std::lock_guard<std::mutex> job( _jobMutex );
+
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _task   = [&task]( std::size_t i ) { task( i ); };
+    _count  = count;
+    _next   = 0;
+    _joined = std::min( _concurrency.load(), count ) - 1;                 // the calling thread takes one share itself
+    _error  = nullptr;
+    ++_generation;
+  }
+  _wakeUp.notify_all();
+
+  runTasks();
+
+  std::unique_lock<std::mutex> lock( _mutex );
+  _joined = 0;                                                            // late risers must not join a finished job
+  _finished.wait( lock, [this] { return _busy == 0; } );
+
+  _task = nullptr;
+  if( _error ) std::rethrow_exception( _error );
+}
+
+
+
+inline void TaskPool::workerLoop()
+{
+  std::size_t seenGeneration = 0;
+
+  while( true )
+  {
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+      _wakeUp.wait( lock, [&] { return _stopping  ||  ( _generation != seenGeneration  &&  _joined > 0 ); } );
+
+      if( _stopping ) return;
+
+      seenGeneration = _generation;
+      --_joined;
+      ++_busy;
+    }
+
+    runTasks();
+
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      --_busy;
+    }
+    _finished.notify_all();
+  }
+}
+
+
+
+inline void TaskPool::runTasks()
+{
+  insideTask() = true;
+
+  for( auto i = _next++;  i < _count;  i = _next++ )
+  {
+    try
+    {
+      _task( i );
+    }
+    catch( ... )
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      if( !_error ) _error = std::current_exception();
+      _next = _count;                                                     // abandon the rest of the job
+    }
+  }
+
+  insideTask() = false;
+}
+
+
+
+inline bool & TaskPool::insideTask()
+{
+  thread_local bool inside = false;
+  return inside;
+}
@@ -0,0 +1,537 @@
+#pragma once
+
+#include <algorithm>                                                      // find(), count(), min_element(), max_element(), min(), max()
+#include <atomic>                                                         // atomic
+#include <cstddef>                                                        // size_t
+#include <cstdint>                                                        // int32_t
+#include <cstring>                                                        // memcpy()
+#include <numeric>                                                        // accumulate()
+#include <stdexcept>                                                      // range_error
+#include <type_traits>                                                    // is_same, is_floating_point, is_signed, conditional, remove_cv
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) )  &&  defined( __x86_64__ )
+  #define VECTOR_KERNELS_X86                                              // SSE2 is part of x86-64, AVX2 and POPCNT are checked for at run time
+  #define VECTOR_KERNELS_AVX2  __attribute__(( target( "avx2,popcnt" ) ))
+  #include <immintrin.h>
+#endif
+
+
+
+
+/*******************************************************************************
+** Search and reduction kernels for contiguous ranges of arithmetic elements, such as an ExtendableVector, FixedVector, or SmallVector
+**
+** find(), count(), min(), max(), and sum() take either a [first, last) pointer range or the vector itself.  For int32_t, float, and
+** double elements they compare or add 32 bytes (AVX2) or 16 bytes (SSE2) of elements per instruction, choosing the widest instruction
+** set the processor supports the first time they're called.  Other element types, other compilers, and other processors use the scalar
+** standard algorithms.  limitInstructionSet() caps the choice, so the narrower kernels can be checked and timed against each other.
+**
+** Differences from the scalar loops:
+**   o  floating point sums are added in a different order, so the result may be rounded differently
+**   o  integer sums are returned as long long (or unsigned long long) so they don't overflow
+**   o  min() and max() of floating point elements that include NaN are unspecified
+*******************************************************************************/
+namespace VectorKernels
+{
+  enum class InstructionSet { SCALAR, SSE2, AVX2 };
+
+  InstructionSet instructionSet     ();                                   // The widest instruction set the kernels use
+  void           limitInstructionSet( InstructionSet widest );            // Caps the instruction set used, at most what the processor supports
+
+  template<typename T>
+  using Sum = std::conditional_t<std::is_floating_point_v<T>, T, std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>>;
+
+
+  // Pointer ranges.  The value searched for is converted to the element type
+  template<typename T>  T *                          find ( T * first, T * last, std::remove_cv_t<T> value );   // last if not found
+  template<typename T>  std::size_t                  count( T * first, T * last, std::remove_cv_t<T> value );
+  template<typename T>  std::remove_cv_t<T>          min  ( T * first, T * last );                              // Throws std::range_error if empty
+  template<typename T>  std::remove_cv_t<T>          max  ( T * first, T * last );                              // Throws std::range_error if empty
+  template<typename T>  Sum<std::remove_cv_t<T>>     sum  ( T * first, T * last );
+
+
+  // Whole vectors, whose begin() and end() must be pointers
+  template<typename Vector, typename T>  auto find ( Vector & vector, const T & value );
+  template<typename Vector, typename T>  auto count( Vector & vector, const T & value );
+  template<typename Vector>              auto min  ( Vector & vector );
+  template<typename Vector>              auto max  ( Vector & vector );
+  template<typename Vector>              auto sum  ( Vector & vector );
+}
+
+
+
+
+
+
+// Implementation
+
+namespace VectorKernels
+{
+  template<typename T>
+  constexpr bool HAS_KERNELS = std::is_same_v<T, std::int32_t>  ||  std::is_same_v<T, float>  ||  std::is_same_v<T, double>;
+
+
+
+  #ifdef VECTOR_KERNELS_X86
+  /*******************************************************************************
+  ** Each instruction set's Lanes<T> wraps the handful of intrinsics the kernels need for one element type:
+  **   load( p )             LANES elements starting at p, which need not be aligned
+  **   broadcast( value )    every lane set to value
+  **   equal( a, b )         a bit mask, bit i set when lane i of a equals lane i of b
+  **   min( a, b ), max( a, b )
+  **   zero(), add( sum, a ) sum is a vector of partial sums, int32_t lanes are widened to 64 bits as they're added
+  **   total( sum )          the partial sums added together
+  *******************************************************************************/
+  namespace Sse2
+  {
+    template<typename T> struct Lanes;
+
+    template<> struct Lanes<std::int32_t>
+    {
+      using Vector = __m128i;
+      static constexpr std::size_t LANES = 4;
+
+      static Vector    load     ( const std::int32_t * p )     { return _mm_loadu_si128( reinterpret_cast<const __m128i *>( p ) ); }
+      static Vector    broadcast( std::int32_t value )         { return _mm_set1_epi32( value ); }
+      static unsigned  equal    ( Vector a, Vector b )         { return static_cast<unsigned>( _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( a, b ) ) ) ); }
+      static Vector    min      ( Vector a, Vector b )         { auto greater = _mm_cmpgt_epi32( a, b );  return _mm_or_si128( _mm_and_si128( greater, b ), _mm_andnot_si128( greater, a ) ); }
+      static Vector    max      ( Vector a, Vector b )         { auto greater = _mm_cmpgt_epi32( a, b );  return _mm_or_si128( _mm_and_si128( greater, a ), _mm_andnot_si128( greater, b ) ); }
+
+      static Vector    zero     ()                             { return _mm_setzero_si128(); }
+      static Vector    add      ( Vector sum, Vector a )       { auto sign = _mm_srai_epi32( a, 31 );                                        // SSE2 has no sign extension, so
+                                                                 sum = _mm_add_epi64( sum, _mm_unpacklo_epi32( a, sign ) );                // interleave each element with
+                                                                 return _mm_add_epi64( sum, _mm_unpackhi_epi32( a, sign ) ); }             // its sign bits
+      static long long total    ( Vector sum )                 { alignas( 16 ) long long lanes[2];  _mm_store_si128( reinterpret_cast<__m128i *>( lanes ), sum );  return lanes[0] + lanes[1]; }
+    };
+
+    template<> struct Lanes<float>
+    {
+      using Vector = __m128;
+      static constexpr std::size_t LANES = 4;
+
+      static Vector    load     ( const float * p )            { return _mm_loadu_ps( p ); }
+      static Vector    broadcast( float value )                { return _mm_set1_ps( value ); }
+      static unsigned  equal    ( Vector a, Vector b )         { return static_cast<unsigned>( _mm_movemask_ps( _mm_cmpeq_ps( a, b ) ) ); }
+      static Vector    min      ( Vector a, Vector b )         { return _mm_min_ps( a, b ); }
+      static Vector    max      ( Vector a, Vector b )         { return _mm_max_ps( a, b ); }
+
+      static Vector    zero     ()                             { return _mm_setzero_ps(); }
+      static Vector    add      ( Vector sum, Vector a )       { return _mm_add_ps( sum, a ); }
+      static float     total    ( Vector sum )                 { alignas( 16 ) float lanes[4];  _mm_store_ps( lanes, sum );  return ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ); }
+    };
+
+    template<> struct Lanes<double>
+    {
+      using Vector = __m128d;
+      static constexpr std::size_t LANES = 2;
+
+      static Vector    load     ( const double * p )           { return _mm_loadu_pd( p ); }
+      static Vector    broadcast( double value )               { return _mm_set1_pd( value ); }
+      static unsigned  equal    ( Vector a, Vector b )         { return static_cast<unsigned>( _mm_movemask_pd( _mm_cmpeq_pd( a, b ) ) ); }
+      static Vector    min      ( Vector a, Vector b )         { return _mm_min_pd( a, b ); }
+      static Vector    max      ( Vector a, Vector b )         { return _mm_max_pd( a, b ); }
+
+      static Vector    zero     ()                             { return _mm_setzero_pd(); }
+      static Vector    add      ( Vector sum, Vector a )       { return _mm_add_pd( sum, a ); }
+      static double    total    ( Vector sum )                 { alignas( 16 ) double lanes[2];  _mm_store_pd( lanes, sum );  return lanes[0] + lanes[1]; }
+    };
+
+
+
+
+    // Without the POPCNT instruction __builtin_popcount() is a library call, but an SSE2 block's mask is at most 16 bits
+    inline unsigned bitsSet( unsigned mask )
+    {
+      static constexpr unsigned char BITS_IN_NIBBLE[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+      return BITS_IN_NIBBLE[ mask & 15 ] + BITS_IN_NIBBLE[ mask >> 4 & 15 ] + BITS_IN_NIBBLE[ mask >> 8 & 15 ] + BITS_IN_NIBBLE[ mask >> 12 ];
+    }
+
+
+
+    // The kernels work through blocks of 4 vectors, then single vectors, then the last few elements one at a time.  4 independent
+    // partial results per block keep the processor from waiting on each add or compare before starting the next
+    template<typename T>
+    std::size_t find( const T * data, std::size_t n, T value )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      auto        target = L::broadcast( value );
+      std::size_t i      = 0;
+      for( ;  i + BLOCK <= n;  i += BLOCK )
+      {
+        unsigned mask = 0;
+        for( std::size_t k = 0;  k < 4;  ++k ) mask |= L::equal( L::load( data + i + k * L::LANES ), target ) << k * L::LANES;
+        if( mask != 0 ) return i + static_cast<std::size_t>( __builtin_ctz( mask ) );
+      }
+      for( ;  i < n;  ++i ) if( data[i] == value ) return i;
+      return n;
+    }
+
+
+
+    template<typename T>
+    std::size_t count( const T * data, std::size_t n, T value )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      auto        target = L::broadcast( value );
+      std::size_t found  = 0;
+      std::size_t i      = 0;
+      for( ;  i + BLOCK <= n;  i += BLOCK )
+      {
+        unsigned mask = 0;
+        for( std::size_t k = 0;  k < 4;  ++k ) mask |= L::equal( L::load( data + i + k * L::LANES ), target ) << k * L::LANES;
+        found += bitsSet( mask );
+      }
+      for( ;  i < n;  ++i ) found += data[i] == value;
+      return found;
+    }
+
+
+
+    // Called only with n >= 1.  Smallest is true for min(), false for max()
+    template<bool Smallest, typename T>
+    T extreme( const T * data, std::size_t n )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      T           result = data[0];
+      std::size_t i      = 0;
+      if( n >= BLOCK )
+      {
+        typename L::Vector partial[4] = { L::load( data ), L::load( data + L::LANES ), L::load( data + 2 * L::LANES ), L::load( data + 3 * L::LANES ) };
+        for( i = BLOCK;  i + BLOCK <= n;  i += BLOCK )
+        {
+          for( std::size_t k = 0;  k < 4;  ++k ) partial[k] = Smallest ? L::min( partial[k], L::load( data + i + k * L::LANES ) )
+                                                                      : L::max( partial[k], L::load( data + i + k * L::LANES ) );
+        }
+
+        alignas( 32 ) T lanes[ BLOCK ];
+        for( std::size_t k = 0;  k < 4;  ++k ) std::memcpy( lanes + k * L::LANES, &partial[k], sizeof partial[k] );
+        result = Smallest ? *std::min_element( lanes, lanes + BLOCK ) : *std::max_element( lanes, lanes + BLOCK );
+      }
+      for( ;  i < n;  ++i ) result = Smallest ? std::min( result, data[i] ) : std::max( result, data[i] );
+      return result;
+    }
+
+
+
+    template<typename T>
+    Sum<T> sum( const T * data, std::size_t n )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      typename L::Vector partial[4] = { L::zero(), L::zero(), L::zero(), L::zero() };
+      std::size_t        i          = 0;
+      for( ;  i + BLOCK <= n;  i += BLOCK )
+      {
+        for( std::size_t k = 0;  k < 4;  ++k ) partial[k] = L::add( partial[k], L::load( data + i + k * L::LANES ) );
+      }
+
+      Sum<T> result = ( L::total( partial[0] ) + L::total( partial[1] ) ) + ( L::total( partial[2] ) + L::total( partial[3] ) );
+      for( ;  i < n;  ++i ) result += data[i];
+      return result;
+    }
+  }    // namespace Sse2
+
+
+
+
+  // The same kernels 8 int32_t or float, or 4 double, lanes wide.  Everything here is compiled for AVX2 whatever the compiler's
+  // options are, and is only called once the processor is known to support it
+  namespace Avx2
+  {
+    template<typename T> struct Lanes;
+
+    template<> struct Lanes<std::int32_t>
+    {
+      using Vector = __m256i;
+      static constexpr std::size_t LANES = 8;
+
+      VECTOR_KERNELS_AVX2 static Vector    load     ( const std::int32_t * p )  { return _mm256_loadu_si256( reinterpret_cast<const __m256i *>( p ) ); }
+      VECTOR_KERNELS_AVX2 static Vector    broadcast( std::int32_t value )      { return _mm256_set1_epi32( value ); }
+      VECTOR_KERNELS_AVX2 static unsigned  equal    ( Vector a, Vector b )      { return static_cast<unsigned>( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( a, b ) ) ) ); }
+      VECTOR_KERNELS_AVX2 static Vector    min      ( Vector a, Vector b )      { return _mm256_min_epi32( a, b ); }
+      VECTOR_KERNELS_AVX2 static Vector    max      ( Vector a, Vector b )      { return _mm256_max_epi32( a, b ); }
+
+      VECTOR_KERNELS_AVX2 static Vector    zero     ()                          { return _mm256_setzero_si256(); }
+      VECTOR_KERNELS_AVX2 static Vector    add      ( Vector sum, Vector a )    { sum = _mm256_add_epi64( sum, _mm256_cvtepi32_epi64( _mm256_castsi256_si128( a ) ) );
+                                                                                  return  _mm256_add_epi64( sum, _mm256_cvtepi32_epi64( _mm256_extracti128_si256( a, 1 ) ) ); }
+      VECTOR_KERNELS_AVX2 static long long total    ( Vector sum )              { alignas( 32 ) long long lanes[4];  _mm256_store_si256( reinterpret_cast<__m256i *>( lanes ), sum );  return ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ); }
+    };
+
+    template<> struct Lanes<float>
+    {
+      using Vector = __m256;
+      static constexpr std::size_t LANES = 8;
+
+      VECTOR_KERNELS_AVX2 static Vector    load     ( const float * p )         { return _mm256_loadu_ps( p ); }
+      VECTOR_KERNELS_AVX2 static Vector    broadcast( float value )             { return _mm256_set1_ps( value ); }
+      VECTOR_KERNELS_AVX2 static unsigned  equal    ( Vector a, Vector b )      { return static_cast<unsigned>( _mm256_movemask_ps( _mm256_cmp_ps( a, b, _CMP_EQ_OQ ) ) ); }
+      VECTOR_KERNELS_AVX2 static Vector    min      ( Vector a, Vector b )      { return _mm256_min_ps( a, b ); }
+      VECTOR_KERNELS_AVX2 static Vector    max      ( Vector a, Vector b )      { return _mm256_max_ps( a, b ); }
+
+      VECTOR_KERNELS_AVX2 static Vector    zero     ()                          { return _mm256_setzero_ps(); }
+      VECTOR_KERNELS_AVX2 static Vector    add      ( Vector sum, Vector a )    { return _mm256_add_ps( sum, a ); }
+      VECTOR_KERNELS_AVX2 static float     total    ( Vector sum )              { alignas( 32 ) float lanes[8];  _mm256_store_ps( lanes, sum );
+                                                                                  return ( ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ) ) + ( ( lanes[4] + lanes[5] ) + ( lanes[6] + lanes[7] ) ); }
+    };
+
+    template<> struct Lanes<double>
+    {
+      using Vector = __m256d;
+      static constexpr std::size_t LANES = 4;
+
+      VECTOR_KERNELS_AVX2 static Vector    load     ( const double * p )        { return _mm256_loadu_pd( p ); }
+      VECTOR_KERNELS_AVX2 static Vector    broadcast( double value )            { return _mm256_set1_pd( value ); }
+      VECTOR_KERNELS_AVX2 static unsigned  equal    ( Vector a, Vector b )      { return static_cast<unsigned>( _mm256_movemask_pd( _mm256_cmp_pd( a, b, _CMP_EQ_OQ ) ) ); }
+      VECTOR_KERNELS_AVX2 static Vector    min      ( Vector a, Vector b )      { return _mm256_min_pd( a, b ); }
+      VECTOR_KERNELS_AVX2 static Vector    max      ( Vector a, Vector b )      { return _mm256_max_pd( a, b ); }
+
+      VECTOR_KERNELS_AVX2 static Vector    zero     ()                          { return _mm256_setzero_pd(); }
+      VECTOR_KERNELS_AVX2 static Vector    add      ( Vector sum, Vector a )    { return _mm256_add_pd( sum, a ); }
+      VECTOR_KERNELS_AVX2 static double    total    ( Vector sum )              { alignas( 32 ) double lanes[4];  _mm256_store_pd( lanes, sum );  return ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ); }
+    };
+
+
+
+
+    template<typename T>
+    VECTOR_KERNELS_AVX2 std::size_t find( const T * data, std::size_t n, T value )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      auto        target = L::broadcast( value );
+      std::size_t i      = 0;
+      for( ;  i + BLOCK <= n;  i += BLOCK )
+      {
+        unsigned mask = 0;
+        for( std::size_t k = 0;  k < 4;  ++k ) mask |= L::equal( L::load( data + i + k * L::LANES ), target ) << k * L::LANES;
+        if( mask != 0 ) return i + static_cast<std::size_t>( __builtin_ctz( mask ) );
+      }
+      for( ;  i < n;  ++i ) if( data[i] == value ) return i;
+      return n;
+    }
+
+
+
+    template<typename T>
+    VECTOR_KERNELS_AVX2 std::size_t count( const T * data, std::size_t n, T value )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      auto        target = L::broadcast( value );
+      std::size_t found  = 0;
+      std::size_t i      = 0;
+      for( ;  i + BLOCK <= n;  i += BLOCK )
+      {
+        unsigned mask = 0;
+        for( std::size_t k = 0;  k < 4;  ++k ) mask |= L::equal( L::load( data + i + k * L::LANES ), target ) << k * L::LANES;
+        found += static_cast<std::size_t>( __builtin_popcount( mask ) );                // a single POPCNT instruction
+      }
+      for( ;  i < n;  ++i ) found += data[i] == value;
+      return found;
+    }
+
+
+
+    template<bool Smallest, typename T>
+    VECTOR_KERNELS_AVX2 T extreme( const T * data, std::size_t n )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      T           result = data[0];
+      std::size_t i      = 0;
+      if( n >= BLOCK )
+      {
+        typename L::Vector partial[4] = { L::load( data ), L::load( data + L::LANES ), L::load( data + 2 * L::LANES ), L::load( data + 3 * L::LANES ) };
+        for( i = BLOCK;  i + BLOCK <= n;  i += BLOCK )
+        {
+          for( std::size_t k = 0;  k < 4;  ++k ) partial[k] = Smallest ? L::min( partial[k], L::load( data + i + k * L::LANES ) )
+                                                                      : L::max( partial[k], L::load( data + i + k * L::LANES ) );
+        }
+
+        alignas( 32 ) T lanes[ BLOCK ];
+        for( std::size_t k = 0;  k < 4;  ++k ) std::memcpy( lanes + k * L::LANES, &partial[k], sizeof partial[k] );
+        result = Smallest ? *std::min_element( lanes, lanes + BLOCK ) : *std::max_element( lanes, lanes + BLOCK );
+      }
+      for( ;  i < n;  ++i ) result = Smallest ? std::min( result, data[i] ) : std::max( result, data[i] );
+      return result;
+    }
+
+
+
+    template<typename T>
+    VECTOR_KERNELS_AVX2 Sum<T> sum( const T * data, std::size_t n )
+    {
+      using L = Lanes<T>;
+      constexpr std::size_t BLOCK = 4 * L::LANES;
+
+      typename L::Vector partial[4] = { L::zero(), L::zero(), L::zero(), L::zero() };
+      std::size_t        i          = 0;
+      for( ;  i + BLOCK <= n;  i += BLOCK )
+      {
+        for( std::size_t k = 0;  k < 4;  ++k ) partial[k] = L::add( partial[k], L::load( data + i + k * L::LANES ) );
+      }
+
+      Sum<T> result = ( L::total( partial[0] ) + L::total( partial[1] ) ) + ( L::total( partial[2] ) + L::total( partial[3] ) );
+      for( ;  i < n;  ++i ) result += data[i];
+      return result;
+    }
+  }    // namespace Avx2
+  #endif    // VECTOR_KERNELS_X86
+
+
+
+
+  inline InstructionSet supportedInstructionSet()
+  {
+    #ifdef VECTOR_KERNELS_X86
+      __builtin_cpu_init();
+      if( __builtin_cpu_supports( "avx2" )  &&  __builtin_cpu_supports( "popcnt" ) ) return InstructionSet::AVX2;
+      return InstructionSet::SSE2;
+    #else
+      return InstructionSet::SCALAR;
+    #endif
+  }
+
+  inline std::atomic<InstructionSet> & widestAllowed()
+  {
+    static std::atomic<InstructionSet> widest{ InstructionSet::AVX2 };
+    return widest;
+  }
+
+
+
+  inline InstructionSet instructionSet()
+  {
+    static const InstructionSet supported = supportedInstructionSet();    // thread safe initialization on first use
+    return std::min( supported, widestAllowed().load( std::memory_order_relaxed ) );
+  }
+
+
+
+  inline void limitInstructionSet( InstructionSet widest )
+  { widestAllowed() = widest; }
+
+
+
+  // Each kernel below hands int32_t, float, and double ranges to the widest kernels allowed, and everything else to the standard
+  // algorithm a scalar loop would use
+  template<typename T>
+  T * find( T * first, T * last, std::remove_cv_t<T> value )
+  {
+    #ifdef VECTOR_KERNELS_X86
+      if constexpr( HAS_KERNELS<std::remove_cv_t<T>> )
+      {
+        auto n = static_cast<std::size_t>( last - first );
+        switch( instructionSet() )
+        {
+          case InstructionSet::AVX2:    return first + Avx2::find( first, n, value );
+          case InstructionSet::SSE2:    return first + Sse2::find( first, n, value );
+          case InstructionSet::SCALAR:  break;
+        }
+      }
+    #endif
+    return std::find( first, last, value );
+  }
+
+
+
+  template<typename T>
+  std::size_t count( T * first, T * last, std::remove_cv_t<T> value )
+  {
+    #ifdef VECTOR_KERNELS_X86
+      if constexpr( HAS_KERNELS<std::remove_cv_t<T>> )
+      {
+        auto n = static_cast<std::size_t>( last - first );
+        switch( instructionSet() )
+        {
+          case InstructionSet::AVX2:    return Avx2::count( first, n, value );
+          case InstructionSet::SSE2:    return Sse2::count( first, n, value );
+          case InstructionSet::SCALAR:  break;
+        }
+      }
+    #endif
+    return static_cast<std::size_t>( std::count( first, last, value ) );
+  }
+
+
+
+  template<typename T>
+  std::remove_cv_t<T> min( T * first, T * last )
+  {
+    if( first == last ) throw std::range_error( "min of an empty range" );
+
+    #ifdef VECTOR_KERNELS_X86
+      if constexpr( HAS_KERNELS<std::remove_cv_t<T>> )
+      {
+        auto n = static_cast<std::size_t>( last - first );
+        switch( instructionSet() )
+        {
+          case InstructionSet::AVX2:    return Avx2::extreme<true>( first, n );
+          case InstructionSet::SSE2:    return Sse2::extreme<true>( first, n );
+          case InstructionSet::SCALAR:  break;
+        }
+      }
+    #endif
+    return *std::min_element( first, last );
+  }
+
+
+
+  template<typename T>
+  std::remove_cv_t<T> max( T * first, T * last )
+  {
+    if( first == last ) throw std::range_error( "max of an empty range" );
+
+    #ifdef VECTOR_KERNELS_X86
+      if constexpr( HAS_KERNELS<std::remove_cv_t<T>> )
+      {
+        auto n = static_cast<std::size_t>( last - first );
+        switch( instructionSet() )
+        {
+          case InstructionSet::AVX2:    return Avx2::extreme<false>( first, n );
+          case InstructionSet::SSE2:    return Sse2::extreme<false>( first, n );
+          case InstructionSet::SCALAR:  break;
+        }
+      }
+    #endif
+    return *std::max_element( first, last );
+  }
+
+
+
+  template<typename T>
+  Sum<std::remove_cv_t<T>> sum( T * first, T * last )
+  {
+    #ifdef VECTOR_KERNELS_X86
+      if constexpr( HAS_KERNELS<std::remove_cv_t<T>> )
+      {
+        auto n = static_cast<std::size_t>( last - first );
+        switch( instructionSet() )
+        {
+          case InstructionSet::AVX2:    return Avx2::sum( first, n );
+          case InstructionSet::SSE2:    return Sse2::sum( first, n );
+          case InstructionSet::SCALAR:  break;
+        }
+      }
+    #endif
+    return std::accumulate( first, last, Sum<std::remove_cv_t<T>>( 0 ) );
+  }
+
+
+
+  template<typename Vector, typename T>  auto find ( Vector & vector, const T & value )  { return VectorKernels::find ( vector.begin(), vector.end(), value ); }
+  template<typename Vector, typename T>  auto count( Vector & vector, const T & value )  { return VectorKernels::count( vector.begin(), vector.end(), value ); }
+  template<typename Vector>              auto min  ( Vector & vector )                   { return VectorKernels::min  ( vector.begin(), vector.end() ); }
+  template<typename Vector>              auto max  ( Vector & vector )                   { return VectorKernels::max  ( vector.begin(), vector.end() ); }
+  template<typename Vector>              auto sum  ( Vector & vector )                   { return VectorKernels::sum  ( vector.begin(), vector.end() ); }
+}    // namespace VectorKernels